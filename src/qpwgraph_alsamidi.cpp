@@ -191,6 +191,15 @@ void qpwgraph_alsamidi::connectPorts (
 }
 
 
+// ALSA port (dis)connections, batched.
+void qpwgraph_alsamidi::connectPorts (
+	const qpwgraph_port::Pairs& pairs, bool is_connect )
+{
+	foreach (const qpwgraph_port::Pair& pair, pairs)
+		connectPorts(pair.first, pair.second, is_connect);
+}
+
+
 // ALSA node type inquirer. (static)
 bool qpwgraph_alsamidi::isNodeType ( uint node_type )
 {
@@ -280,6 +289,7 @@ bool qpwgraph_alsamidi::findClientPort (
 	}
 
 	if (add_new && *port == nullptr && *node) {
+		qpwgraph_sect::beginNodeEdit(*node);
 		*port = (*node)->addPort(port_id, port_name, port_mode, port_type);
 		(*port)->updatePortTypeColors(canvas);
 		qpwgraph_sect::addItem(*port);
@@ -351,6 +361,10 @@ void qpwgraph_alsamidi::updateItems (void)
 		}
 	}
 
+	// Lay out all new ports, once per node...
+	//
+	qpwgraph_sect::commitNodeEdits();
+
 	// 2. Connections inventory...
 	//
 	snd_seq_client_info_t *client_info2;
@@ -59,6 +59,9 @@ public:
 	// ALSA port (dis)connection.
 	void connectPorts(qpwgraph_port *port1, qpwgraph_port *port2, bool is_connect);
 
+	// ALSA port (dis)connections, batched.
+	void connectPorts(const qpwgraph_port::Pairs& pairs, bool is_connect);
+
 	// ALSA graph updaters.
 	void updateItems();
 	void clearItems();
@@ -0,0 +1,106 @@
+// qpwgraph_atom.cpp
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qpwgraph_atom.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_atom -- Interned string (process-wide string pool).
+
+struct qpwgraph_atom_pool
+{
+	~qpwgraph_atom_pool() { qDeleteAll(names); }
+
+	QMutex mutex;
+	QHash<QString, const QString *> names;
+};
+
+static
+qpwgraph_atom_pool& qpwgraph_atom_pool_instance (void)
+{
+	static qpwgraph_atom_pool pool;
+
+	return pool;
+}
+
+
+// String pool methods (static).
+const QString *qpwgraph_atom::intern ( const QString& name )
+{
+	if (name.isEmpty())
+		return null_name();
+
+	qpwgraph_atom_pool& pool = qpwgraph_atom_pool_instance();
+	QMutexLocker locker(&pool.mutex);
+
+	const QString *str = pool.names.value(name, nullptr);
+	if (str == nullptr) {
+		str = new QString(name);
+		pool.names.insert(*str, str);
+	}
+
+	return str;
+}
+
+
+const QString *qpwgraph_atom::null_name (void)
+{
+	static const QString null_str;
+
+	return &null_str;
+}
+
+
+const QString *qpwgraph_atom::no_name (void)
+{
+	static const QString no_str;
+
+	return &no_str;
+}
+
+
+// Existing atom, or a null one, if not interned (static).
+qpwgraph_atom qpwgraph_atom::lookup ( const QString& name )
+{
+	if (name.isEmpty())
+		return qpwgraph_atom();
+
+	qpwgraph_atom_pool& pool = qpwgraph_atom_pool_instance();
+	QMutexLocker locker(&pool.mutex);
+
+	return qpwgraph_atom(pool.names.value(name, no_name()));
+}
+
+
+// Number of interned strings (static).
+int qpwgraph_atom::count (void)
+{
+	qpwgraph_atom_pool& pool = qpwgraph_atom_pool_instance();
+	QMutexLocker locker(&pool.mutex);
+
+	return pool.names.count();
+}
+
+
+// end of qpwgraph_atom.cpp
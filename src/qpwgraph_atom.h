@@ -0,0 +1,107 @@
+// qpwgraph_atom.h
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qpwgraph_atom_h
+#define __qpwgraph_atom_h
+
+#include <QString>
+#include <QHash>
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_atom -- Interned string (process-wide string pool).
+//
+// Equal strings are stored only once and for good; an atom is just a
+// pointer into the pool, so that hashing and equality are plain integer
+// operations. Interning is thread-safe; reading an atom needs no lock.
+// Mere lookups (eg. finding items by some given name) should rather use
+// lookup(), which never adds to the pool and yields a null atom, equal
+// to no other, for a string not interned yet.
+//
+
+class qpwgraph_atom
+{
+public:
+
+	// Constructors.
+	qpwgraph_atom() : m_name(null_name()) {}
+	explicit qpwgraph_atom(const QString& name) : m_name(intern(name)) {}
+
+	qpwgraph_atom(const qpwgraph_atom& atom) : m_name(atom.m_name) {}
+
+	// Assignment.
+	qpwgraph_atom& operator= (const qpwgraph_atom& atom)
+		{ m_name = atom.m_name; return *this; }
+
+	// Accessors.
+	const QString& name() const
+		{ return *m_name; }
+	operator const QString& () const
+		{ return *m_name; }
+
+	bool isEmpty() const
+		{ return m_name->isEmpty(); }
+
+	// Not-interned (lookup) result.
+	bool isNull() const
+		{ return m_name == no_name(); }
+
+	// Atom identifier (unique while the process lives).
+	quintptr id() const
+		{ return quintptr(m_name); }
+
+	// Comparators.
+	bool operator== (const qpwgraph_atom& atom) const
+		{ return m_name == atom.m_name; }
+	bool operator!= (const qpwgraph_atom& atom) const
+		{ return m_name != atom.m_name; }
+
+	// Existing atom, or a null one, if not interned (static).
+	static qpwgraph_atom lookup(const QString& name);
+
+	// Number of interned strings (static).
+	static int count();
+
+private:
+
+	// Pooled string constructor.
+	explicit qpwgraph_atom(const QString *name) : m_name(name) {}
+
+	// String pool methods (static).
+	static const QString *intern(const QString& name);
+	static const QString *null_name();
+	static const QString *no_name();
+
+	// Instance variables.
+	const QString *m_name;
+};
+
+
+// Atom hash function.
+inline uint qHash ( const qpwgraph_atom& atom )
+{
+	return qHash(atom.id());
+}
+
+
+#endif	// __qpwgraph_atom_h
+
+// end of qpwgraph_atom.h
@@ -0,0 +1,1227 @@
+// qpwgraph_bench.cpp
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "config.h"
+
+#include "qpwgraph_canvas.h"
+#include "qpwgraph_patchbay.h"
+#include "qpwgraph_pipewire.h"
+#include "qpwgraph_node.h"
+#include "qpwgraph_port.h"
+#include "qpwgraph_toposort.h"
+#include "qpwgraph_list.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <QSet>
+#include <QFileInfo>
+#include <QFile>
+
+#include <QDomDocument>
+#include <QTextStream>
+
+#include <algorithm>
+
+#include <cstdio>
+#include <cstring>
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_bench -- Micro-benchmarks (opt-in, CONFIG_BENCHMARKS).
+//
+// Usage: qpwgraph_bench [case [count]]
+//
+// Each case times its steps in wall-clock milliseconds, along with
+// the peak resident memory growth of each step (Linux only).
+//
+
+// Peak resident memory (kB) helpers.
+static long bench_status ( const char *key )
+{
+	QFile file("/proc/self/status");
+	if (!file.open(QIODevice::ReadOnly))
+		return 0;
+
+	foreach (const QByteArray& line, file.readAll().split('\n')) {
+		if (line.startsWith(key))
+			return line.mid(int(::strlen(key))).simplified().split(' ').first().toLong();
+	}
+
+	return 0;
+}
+
+
+static void bench_reset_peak (void)
+{
+	// Reset the peak resident memory mark (VmHWM) to the current one.
+	QFile file("/proc/self/clear_refs");
+	if (file.open(QIODevice::WriteOnly))
+		file.write("5");
+}
+
+
+// Benchmark step timer.
+class qpwgraph_bench_step
+{
+public:
+
+	qpwgraph_bench_step(const char *name) : m_name(name)
+	{
+		bench_reset_peak();
+		m_rss = bench_status("VmRSS:");
+		m_timer.start();
+	}
+
+	~qpwgraph_bench_step()
+	{
+		const double msecs = double(m_timer.nsecsElapsed()) / 1000000.0;
+		const long peak = bench_status("VmHWM:") - m_rss;
+		::printf("  %-32s %10.3f ms %10ld kB\n", m_name, msecs, (peak > 0 ? peak : 0));
+	}
+
+private:
+
+	const char   *m_name;
+	long          m_rss;
+	QElapsedTimer m_timer;
+};
+
+
+//----------------------------------------------------------------------------
+// Patchbay rules file load/save: streaming XML vs. compact binary vs.
+// the former whole-document (DOM) XML, on a generated patchbay.
+
+static void bench_patchbay_dom_save (
+	const qpwgraph_patchbay::Items& items, const QString& filename )
+{
+	QDomDocument doc("patchbay");
+	QDomElement eroot = doc.createElement("patchbay");
+	eroot.setAttribute("name", QFileInfo(filename).baseName());
+	eroot.setAttribute("version", PROJECT_VERSION);
+	doc.appendChild(eroot);
+
+	QDomElement eitems = doc.createElement("items");
+	qpwgraph_patchbay::Items::ConstIterator iter = items.constBegin();
+	const qpwgraph_patchbay::Items::ConstIterator& iter_end = items.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		const qpwgraph_patchbay::Item *item = iter.value();
+		QDomElement eitem = doc.createElement("item");
+		eitem.setAttribute("node-type", "pipewire");
+		eitem.setAttribute("port-type", "pipewire-audio");
+		QDomElement eitem1 = doc.createElement("output");
+		eitem1.setAttribute("node", item->node1.name());
+		eitem1.setAttribute("port", item->port1.name());
+		eitem.appendChild(eitem1);
+		QDomElement eitem2 = doc.createElement("input");
+		eitem2.setAttribute("node", item->node2.name());
+		eitem2.setAttribute("port", item->port2.name());
+		eitem.appendChild(eitem2);
+		eitems.appendChild(eitem);
+	}
+	eroot.appendChild(eitems);
+
+	QFile file(filename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return;
+
+	QTextStream ts(&file);
+	ts << doc.toString() << '\n';
+	file.close();
+}
+
+
+static void bench_patchbay_dom_load (
+	qpwgraph_patchbay::Items& items, const QString& filename )
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly))
+		return;
+
+	QDomDocument doc("patchbay");
+	if (!doc.setContent(&file))
+		return;
+
+	file.close();
+
+	// All generated items are PipeWire audio ones.
+	const uint node_type = qpwgraph_pipewire::nodeType();
+	const uint port_type = qpwgraph_pipewire::audioPortType();
+
+	QDomElement edoc = doc.documentElement();
+	for (QDomNode nroot = edoc.firstChild();
+			!nroot.isNull(); nroot = nroot.nextSibling()) {
+		QDomElement eroot = nroot.toElement();
+		if (eroot.isNull() || eroot.tagName() != "items")
+			continue;
+		for (QDomNode nitem = eroot.firstChild();
+				!nitem.isNull(); nitem = nitem.nextSibling()) {
+			QDomElement eitem = nitem.toElement();
+			if (eitem.isNull() || eitem.tagName() != "item")
+				continue;
+			QString node1, port1, node2, port2;
+			for (QDomNode nitem2 = eitem.firstChild();
+					!nitem2.isNull(); nitem2 = nitem2.nextSibling()) {
+				QDomElement eitem2 = nitem2.toElement();
+				if (eitem2.tagName() == "output") {
+					node1 = eitem2.attribute("node");
+					port1 = eitem2.attribute("port");
+				}
+				else
+				if (eitem2.tagName() == "input") {
+					node2 = eitem2.attribute("node");
+					port2 = eitem2.attribute("port");
+				}
+			}
+			items.addItem(qpwgraph_patchbay::Item(
+				node_type, port_type, node1, port1, node2, port2));
+		}
+	}
+}
+
+
+static bool bench_patchbay ( int count )
+{
+	QTemporaryDir dir;
+	if (!dir.isValid())
+		return false;
+
+	// Generated patchbay: 16 ports per client, many clients
+	// feeding fewer sinks, so that names do repeat a lot.
+	const int nclients = (count + 15) / 16;
+	const int nsinks = (nclients + 3) / 4;
+	qpwgraph_patchbay::Items items;
+	for (int i = 0; i < count; ++i) {
+		items.addItem(qpwgraph_patchbay::Item(
+			qpwgraph_pipewire::nodeType(),
+			qpwgraph_pipewire::audioPortType(),
+			QString("Generated Client %1").arg(i / 16),
+			QString("output_%1").arg(i % 16),
+			QString("Generated Sink %1").arg((i / 16) % nsinks),
+			QString("input_%1").arg(i % 16)));
+	}
+
+	qpwgraph_canvas canvas;
+	qpwgraph_patchbay patchbay(&canvas);
+	patchbay.setItems(items);
+
+	const QString& xml_file = dir.filePath("bench.qpwgraph");
+	const QString& bin_file = dir.filePath(
+		"bench." + qpwgraph_patchbay::binaryFileExt());
+	const QString& dom_file = dir.filePath("bench-dom.qpwgraph");
+
+	::printf("patchbay: %d items\n", items.count());
+
+	{ qpwgraph_bench_step step("save: xml (stream)");
+		patchbay.save(xml_file); }
+	{ qpwgraph_bench_step step("save: binary");
+		patchbay.save(bin_file); }
+	{ qpwgraph_bench_step step("save: xml (dom)");
+		bench_patchbay_dom_save(items, dom_file); }
+
+	int nxml = 0, nbin = 0, ndom = 0;
+
+	patchbay.clear();
+	{ qpwgraph_bench_step step("load: xml (stream)");
+		patchbay.load(xml_file); nxml = patchbay.items().count(); }
+	patchbay.clear();
+	{ qpwgraph_bench_step step("load: binary");
+		patchbay.load(bin_file); nbin = patchbay.items().count(); }
+	patchbay.clear();
+	{ qpwgraph_bench_step step("load: xml (dom)");
+		qpwgraph_patchbay::Items items2;
+		bench_patchbay_dom_load(items2, dom_file); ndom = items2.count(); }
+
+	::printf("  file sizes: xml %lld, binary %lld, dom %lld bytes\n",
+		(long long) QFileInfo(xml_file).size(),
+		(long long) QFileInfo(bin_file).size(),
+		(long long) QFileInfo(dom_file).size());
+
+	return (nxml == count && nbin == count && ndom == count);
+}
+
+
+//----------------------------------------------------------------------------
+// PipeWire object store teardown: node, port and link records kept in
+// qpwgraph_list's, removed as qpwgraph_pipewire::removeObject() does
+// (whose own store is private to it and needs a live connection), vs.
+// the same records kept in plain QList's (baseline).
+
+class qpwgraph_bench_objects_ilist
+{
+public:
+
+	// Node, port or link record: one item for each list it belongs to.
+	struct Object
+	{
+		Object(uint oid) : id(oid),
+			object_item(this), owner_item(this), peer_item(this) {}
+		uint id;
+		qpwgraph_list<Object> children;				// ports or links.
+		qpwgraph_list<Object>::Item object_item;	// in store.
+		qpwgraph_list<Object>::Item owner_item;		// in node or port1.
+		qpwgraph_list<Object>::Item peer_item;		// in port2.
+	};
+
+	~qpwgraph_bench_objects_ilist()
+	{
+		while (!m_objects.isEmpty())
+			delete m_objects.first()->object();
+	}
+
+	int count() const { return m_objects.count(); }
+
+	void create(uint id, uint owner_id = 0, uint peer_id = 0)
+	{
+		Object *object = new Object(id);
+		Object *owner = m_objectids.value(owner_id, nullptr);
+		if (owner)
+			owner->children.append(&object->owner_item);
+		Object *peer = m_objectids.value(peer_id, nullptr);
+		if (peer)
+			peer->children.append(&object->peer_item);
+		m_objectids.insert(id, object);
+		m_objects.append(&object->object_item);
+	}
+
+	void remove(uint id)
+	{
+		Object *object = m_objectids.value(id, nullptr);
+		if (object)
+			remove(object);
+	}
+
+	void remove(Object *object)
+	{
+		m_objectids.remove(object->id);
+		m_objects.remove(&object->object_item);
+		while (!object->children.isEmpty())
+			remove(object->children.first()->object());
+		delete object;
+	}
+
+private:
+
+	QHash<uint, Object *> m_objectids;
+	qpwgraph_list<Object> m_objects;
+};
+
+
+// Baseline: linear removals off plain lists.
+class qpwgraph_bench_objects_qlist
+{
+public:
+
+	struct Object
+	{
+		Object(uint oid) : id(oid), owner(nullptr), peer(nullptr) {}
+		uint id;
+		QList<Object *> children;
+		Object *owner;
+		Object *peer;
+	};
+
+	~qpwgraph_bench_objects_qlist() { qDeleteAll(m_objects); }
+
+	int count() const { return m_objects.count(); }
+
+	void create(uint id, uint owner_id = 0, uint peer_id = 0)
+	{
+		Object *object = new Object(id);
+		object->owner = m_objectids.value(owner_id, nullptr);
+		if (object->owner)
+			object->owner->children.append(object);
+		object->peer = m_objectids.value(peer_id, nullptr);
+		if (object->peer)
+			object->peer->children.append(object);
+		m_objectids.insert(id, object);
+		m_objects.append(object);
+	}
+
+	void remove(uint id)
+	{
+		Object *object = m_objectids.value(id, nullptr);
+		if (object)
+			remove(object);
+	}
+
+	void remove(Object *object)
+	{
+		m_objectids.remove(object->id);
+		m_objects.removeAll(object);
+		while (!object->children.isEmpty())
+			remove(object->children.first());
+		if (object->owner)
+			object->owner->children.removeAll(object);
+		if (object->peer)
+			object->peer->children.removeAll(object);
+		delete object;
+	}
+
+private:
+
+	QHash<uint, Object *> m_objectids;
+	QList<Object *> m_objects;
+};
+
+
+// One client node with as many (linked) ports, torn down
+// amongst a thousand other 8-port nodes; milliseconds.
+template <typename Objects>
+static double bench_objects_teardown ( int nports, bool& ok )
+{
+	Objects objects;
+
+	uint id = 0;
+	for (int i = 0; i < 1000; ++i) {
+		const uint node_id = ++id;
+		objects.create(node_id);
+		for (int j = 0; j < 8; ++j)
+			objects.create(++id, node_id);
+	}
+
+	const uint node1_id = ++id;
+	const uint node2_id = ++id;
+	objects.create(node1_id);
+	objects.create(node2_id);
+	for (int i = 0; i < nports; ++i) {
+		const uint port1_id = ++id;
+		const uint port2_id = ++id;
+		objects.create(port1_id, node1_id);
+		objects.create(port2_id, node2_id);
+		objects.create(++id, port1_id, port2_id);
+	}
+
+	// The node, its ports and their links are all gone.
+	const int nremain = objects.count() - (1 + 2 * nports);
+
+	QElapsedTimer timer;
+	timer.start();
+
+	objects.remove(node1_id);
+
+	const double msecs = double(timer.nsecsElapsed()) / 1000000.0;
+
+	ok = ok && (objects.count() == nremain);
+
+	return msecs;
+}
+
+
+static bool bench_objects ( int count )
+{
+	::printf("objects: node teardown, by port count\n");
+	::printf("  %8s %14s %14s\n", "ports", "qlist (ms)", "intrusive (ms)");
+
+	bool ok = true;
+
+	for (int nports = 64; nports <= count; nports *= 4) {
+		const double msecs1
+			= bench_objects_teardown<qpwgraph_bench_objects_qlist> (nports, ok);
+		const double msecs2
+			= bench_objects_teardown<qpwgraph_bench_objects_ilist> (nports, ok);
+		::printf("  %8d %14.3f %14.3f\n", nports, msecs1, msecs2);
+	}
+
+	return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// PipeWire node classification, by media.class and client.api: the former
+// QString::contains() and strcmp() chains vs. the hash tables in use, on
+// a replay of generated node globals (a mix of well-known and unknown).
+
+static void bench_classes_qstring ( const char *str,
+	qpwgraph_item::Mode& node_mode, uint& node_types )
+{
+	const QString media_class(str);
+	if (media_class.contains("Source") ||
+		media_class.contains("Output"))
+		node_mode = qpwgraph_item::Output;
+	else
+	if (media_class.contains("Sink") ||
+		media_class.contains("Input"))
+		node_mode = qpwgraph_item::Input;
+	if (media_class.contains("Audio"))
+		node_types |= 1;	// Node::Audio
+	if (media_class.contains("Video"))
+		node_types |= 2;	// Node::Video
+	if (media_class.contains("Midi"))
+		node_types |= 4;	// Node::Midi
+}
+
+
+static uint bench_classes_strcmp ( const char *client_api )
+{
+	if (::strcmp(client_api, "jack") == 0 ||
+		::strcmp(client_api, "pipewire-jack") == 0)
+		return 1;	// Node::Jack
+	else
+	if (::strcmp(client_api, "pulse") == 0 ||
+		::strcmp(client_api, "pipewire-pulse") == 0)
+		return 2;	// Node::Pulse
+	else
+		return 0;	// Node::Native
+}
+
+
+static bool bench_classes ( int count )
+{
+	static const char *media_classes[] = {
+		"Stream/Output/Audio", "Stream/Output/Audio", "Stream/Output/Audio",
+		"Stream/Input/Audio",  "Stream/Input/Audio",  "Audio/Sink",
+		"Audio/Source",        "Audio/Duplex",        "Audio/Source/Virtual",
+		"Video/Source",        "Stream/Input/Video",  "Midi/Bridge",
+		"Audio/Sink/Internal", "Video/Sink/Monitor",  "Audio/Source/Internal"
+	};
+
+	static const char *client_apis[] = {
+		"pipewire-pulse", "pipewire-pulse", "pipewire-jack",
+		"pulse", "jack", "native", "gstreamer"
+	};
+
+	const int nclasses = int(sizeof(media_classes) / sizeof(media_classes[0]));
+	const int napis = int(sizeof(client_apis) / sizeof(client_apis[0]));
+
+	QRandomGenerator random(count);
+	QVector<const char *> media_class_dump;
+	QVector<const char *> client_api_dump;
+	media_class_dump.reserve(count);
+	client_api_dump.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		media_class_dump.append(media_classes[random.bounded(nclasses)]);
+		client_api_dump.append(client_apis[random.bounded(napis)]);
+	}
+
+	// Each replay is run a few times over, for steadier timings.
+	const int npasses = 10;
+
+	QVector<uint> results1(count);
+	QVector<uint> results2(count);
+
+	::printf("classes: %d node globals, %d passes\n", count, npasses);
+
+	{ qpwgraph_bench_step step("media.class: qstring");
+		for (int n = 0; n < npasses; ++n) {
+			for (int i = 0; i < count; ++i) {
+				qpwgraph_item::Mode node_mode = qpwgraph_item::None;
+				uint node_types = 0;
+				bench_classes_qstring(media_class_dump.at(i), node_mode, node_types);
+				results1[i] = (uint(node_mode) << 8) | node_types;
+			}
+		}
+	}
+
+	{ qpwgraph_bench_step step("media.class: table");
+		for (int n = 0; n < npasses; ++n) {
+			for (int i = 0; i < count; ++i) {
+				qpwgraph_item::Mode node_mode = qpwgraph_item::None;
+				uint node_types = 0;
+				qpwgraph_pipewire::mediaClass(media_class_dump.at(i), node_mode, node_types);
+				results2[i] = (uint(node_mode) << 8) | node_types;
+			}
+		}
+	}
+
+	bool ok = (results1 == results2);
+
+	{ qpwgraph_bench_step step("client.api: strcmp");
+		for (int n = 0; n < npasses; ++n) {
+			for (int i = 0; i < count; ++i)
+				results1[i] = bench_classes_strcmp(client_api_dump.at(i));
+		}
+	}
+
+	{ qpwgraph_bench_step step("client.api: table");
+		for (int n = 0; n < npasses; ++n) {
+			for (int i = 0; i < count; ++i)
+				results2[i] = qpwgraph_pipewire::clientApi(client_api_dump.at(i));
+		}
+	}
+
+	return ok && (results1 == results2);
+}
+
+
+//----------------------------------------------------------------------------
+// Port natural sorting: the former character by character comparator
+// vs. plain binary comparison of the (cached) collation keys, on
+// generated port names.
+
+static bool bench_sort_less_than ( const QString& s1, const QString& s2 )
+{
+	const int n1 = s1.length();
+	const int n2 = s2.length();
+
+	int i1, i2;
+
+	for (i1 = i2 = 0; i1 < n1 && i2 < n2; ++i1, ++i2) {
+
+		// Skip (white)spaces...
+		while (s1.at(i1).isSpace())
+			++i1;
+		while (s2.at(i2).isSpace())
+			++i2;
+
+		// Normalize (to uppercase) the next characters...
+		QChar c1 = s1.at(i1).toUpper();
+		QChar c2 = s2.at(i2).toUpper();
+
+		if (c1.isDigit() && c2.isDigit()) {
+			// Find the whole length numbers...
+			int j1 = i1++;
+			while (i1 < n1 && s1.at(i1).isDigit())
+				++i1;
+			int j2 = i2++;
+			while (i2 < n2 && s2.at(i2).isDigit())
+				++i2;
+			// Compare as natural decimal-numbers...
+			j1 = s1.mid(j1, i1 - j1).toInt();
+			j2 = s2.mid(j2, i2 - j2).toInt();
+			if (j1 != j2)
+				return (j1 < j2);
+			// Never go out of bounds...
+			if (i1 >= n1 || i2 >= n2)
+				break;
+			// Go on with this next char...
+			c1 = s1.at(i1).toUpper();
+			c2 = s2.at(i2).toUpper();
+		}
+
+		// Compare this char...
+		if (c1 != c2)
+			return (c1 < c2);
+	}
+
+	// Probable exact match.
+	return false;
+}
+
+
+// Whether the collation keys ever order a pair of names strictly the
+// other way around of the former comparator (equal either way is fine).
+static bool bench_sort_mismatch (
+	const QString& s1, const QString& s2,
+	const QByteArray& key1, const QByteArray& key2 )
+{
+	return (bench_sort_less_than(s1, s2) && key2 < key1)
+		|| (bench_sort_less_than(s2, s1) && key1 < key2);
+}
+
+
+static bool bench_sort ( int count )
+{
+	static const char *fixed_names[] = {
+		"out 9", "out 10", "a01", "a1", "A", "a", "x-1", "x1",
+		"in 2 R", "in 2_L", "in 2-aux", "in 2  L", "Bus 007", "Bus 7b"
+	};
+
+	static const char *prefixes[] = {
+		"playback_", "capture_", "output_", "input_", "monitor_",
+		"out ", "in ", "MIDI ", "Track ", "Bus "
+	};
+
+	static const char *suffixes[] = {
+		"", "", "_FL", "_FR", " L", " R", "-aux"
+	};
+
+	const int nfixed = int(sizeof(fixed_names) / sizeof(fixed_names[0]));
+	const int nprefixes = int(sizeof(prefixes) / sizeof(prefixes[0]));
+	const int nsuffixes = int(sizeof(suffixes) / sizeof(suffixes[0]));
+
+	QStringList names;
+	names.reserve(count + nfixed);
+	for (int i = 0; i < nfixed; ++i)
+		names.append(fixed_names[i]);
+
+	QRandomGenerator random(count);
+	for (int i = 0; i < count; ++i) {
+		names.append(QString(prefixes[random.bounded(nprefixes)])
+			+ QString::number(1 + random.bounded(256))
+			+ suffixes[random.bounded(nsuffixes)]);
+	}
+
+	const int nnames = names.count();
+
+	::printf("sort: %d port names\n", nnames);
+
+	QVector<int> index1(nnames);
+	QVector<int> index2(nnames);
+	for (int i = 0; i < nnames; ++i)
+		index1[i] = index2[i] = i;
+
+	{ qpwgraph_bench_step step("sort: compare strings");
+		std::sort(index1.begin(), index1.end(),
+			[&names](int i1, int i2)
+				{ return bench_sort_less_than(names.at(i1), names.at(i2)); });
+	}
+
+	QVector<QByteArray> keys;
+	keys.reserve(nnames);
+
+	{ qpwgraph_bench_step step("sort: make keys");
+		foreach (const QString& name, names)
+			keys.append(qpwgraph_port::sortKey(name));
+	}
+
+	{ qpwgraph_bench_step step("sort: compare keys");
+		std::sort(index2.begin(), index2.end(),
+			[&keys](int i1, int i2)
+				{ return keys.at(i1) < keys.at(i2); });
+	}
+
+	// Check every pair amongst the fixed and the first few names,
+	// then each neighbouring pair in both sorted orders...
+	QList<QPair<int, int> > mismatches;
+	const int ncheck = qMin(nnames, 2000);
+	for (int i = 0; i < ncheck; ++i) {
+		for (int j = i + 1; j < ncheck; ++j) {
+			if (bench_sort_mismatch(names.at(i), names.at(j), keys.at(i), keys.at(j)))
+				mismatches.append(qMakePair(i, j));
+		}
+	}
+	for (int k = 1; k < nnames; ++k) {
+		const int i1 = index1.at(k - 1), j1 = index1.at(k);
+		if (bench_sort_mismatch(names.at(i1), names.at(j1), keys.at(i1), keys.at(j1)))
+			mismatches.append(qMakePair(i1, j1));
+		const int i2 = index2.at(k - 1), j2 = index2.at(k);
+		if (bench_sort_mismatch(names.at(i2), names.at(j2), keys.at(i2), keys.at(j2)))
+			mismatches.append(qMakePair(i2, j2));
+	}
+
+	for (int k = 0; k < mismatches.count() && k < 8; ++k) {
+		::printf("  mismatch: \"%s\" vs. \"%s\"\n",
+			names.at(mismatches.at(k).first).toUtf8().constData(),
+			names.at(mismatches.at(k).second).toUtf8().constData());
+	}
+
+	return mismatches.isEmpty();
+}
+
+
+//----------------------------------------------------------------------------
+// Repelling overlapping nodes: the former scan of all nodes for each one
+// repelled vs. the canvas in use (uniform grid spatial index), on a
+// synthetic layout where one in every few nodes overlaps its neighbour.
+
+static void bench_repel_scan ( const QList<qpwgraph_node *>& nodes,
+	qpwgraph_node *node, const QPointF& delta = QPointF() )
+{
+	const qreal MIN_NODE_GAP = 8.0f;
+
+	node->setMarked(true);
+
+	QRectF rect1 = node->sceneBoundingRect();
+	rect1.adjust(
+		-2.0 * MIN_NODE_GAP, -MIN_NODE_GAP,
+		+2.0 * MIN_NODE_GAP, +MIN_NODE_GAP);
+
+	foreach (qpwgraph_node *node2, nodes) {
+		if (node2->isMarked())
+			continue;
+		const QPointF& pos1
+			= node2->pos();
+		QPointF pos2 = pos1;
+		const QRectF& rect2
+			= node2->sceneBoundingRect();
+		const QRectF& recti
+			= rect2.intersected(rect1);
+		if (!recti.isNull()) {
+			const QPointF delta2
+				= (delta.isNull() ? rect2.center() - rect1.center() : delta);
+			if (recti.width() < (1.5 * recti.height())) {
+				qreal dx = recti.width();
+				if ((delta2.x() < 0.0 && recti.width() >= rect1.width()) ||
+					(delta2.x() > 0.0 && recti.width() >= rect2.width())) {
+					dx += qAbs(rect2.right() - rect1.right());
+				}
+				else
+				if ((delta2.x() > 0.0 && recti.width() >= rect1.width()) ||
+					(delta2.x() < 0.0 && recti.width() >= rect2.width())) {
+					dx += qAbs(rect2.left() - rect1.left());
+				}
+				if (delta2.x() < 0.0)
+					pos2.setX(pos1.x() - dx);
+				else
+					pos2.setX(pos1.x() + dx);
+			} else {
+				qreal dy = recti.height();
+				if ((delta2.y() < 0.0 && recti.height() >= rect1.height()) ||
+					(delta2.y() > 0.0 && recti.height() >= rect2.height())) {
+					dy += qAbs(rect2.bottom() - rect1.bottom());
+				}
+				else
+				if ((delta2.y() > 0.0 && recti.height() >= rect1.height()) ||
+					(delta2.y() < 0.0 && recti.height() >= rect2.height())) {
+					dy += qAbs(rect2.top() - rect1.top());
+				}
+				if (delta2.y() < 0.0)
+					pos2.setY(pos1.y() - dy);
+				else
+					pos2.setY(pos1.y() + dy);
+			}
+			node2->setPos(pos2);
+			bench_repel_scan(nodes, node2, delta2);
+		}
+	}
+
+	node->setMarked(false);
+}
+
+
+static QSet<int> bench_repel_moved ( const QList<qpwgraph_node *>& nodes,
+	const QList<QPointF>& positions, bool reset )
+{
+	QSet<int> moved;
+
+	const int n = nodes.count();
+	for (int i = 0; i < n; ++i) {
+		qpwgraph_node *node = nodes.at(i);
+		if (node->pos() != positions.at(i))
+			moved.insert(i);
+		if (reset)
+			node->setPos(positions.at(i));
+	}
+
+	return moved;
+}
+
+
+// Nodes still overlapping any other, grown by the very same gap
+// that the canvas keeps in between (nb. exhaustive test).
+static int bench_repel_overlaps ( const QList<qpwgraph_node *>& nodes )
+{
+	const qreal MIN_NODE_GAP = 8.0f;
+
+	QList<QRectF> rects;
+	foreach (qpwgraph_node *node, nodes)
+		rects.append(node->sceneBoundingRect());
+
+	int noverlaps = 0;
+
+	const int n = rects.count();
+	for (int i = 0; i < n; ++i) {
+		const QRectF& rect1 = rects.at(i).adjusted(
+			-2.0 * MIN_NODE_GAP, -MIN_NODE_GAP,
+			+2.0 * MIN_NODE_GAP, +MIN_NODE_GAP);
+		for (int j = 0; j < n; ++j) {
+			if (i != j && rect1.intersects(rects.at(j))) {
+				++noverlaps;
+				break;
+			}
+		}
+	}
+
+	return noverlaps;
+}
+
+
+static bool bench_repel ( int count )
+{
+	if (count < 8)
+		return false;
+
+	qpwgraph_canvas canvas;
+
+	const uint node_type = qpwgraph_pipewire::nodeType();
+	const uint port_type = qpwgraph_pipewire::audioPortType();
+
+	QList<qpwgraph_node *> nodes;
+	uint id = 0;
+	for (int i = 0; i < count; ++i) {
+		qpwgraph_node *node = new qpwgraph_node(++id,
+			QString("Synthetic Node %1").arg(i + 1), qpwgraph_item::Duplex, node_type);
+		node->addInputPort(++id, "input_FL", port_type);
+		node->addInputPort(++id, "input_FR", port_type);
+		node->addOutputPort(++id, "output_FL", port_type);
+		node->addOutputPort(++id, "output_FR", port_type);
+		canvas.addItem(node);
+		nodes.append(node);
+	}
+
+	// Square-ish grid of nodes, with some spacing in between,
+	// but every 8th one shifted over its right neighbour...
+	const int ncols = qMax(1, int(qSqrt(qreal(count))));
+	const QRectF& rect = nodes.first()->boundingRect();
+	const qreal dx = rect.width() + 48.0;
+	const qreal dy = rect.height() + 32.0;
+	QList<QPointF> positions;
+	for (int i = 0; i < count; ++i) {
+		QPointF pos(qreal(i % ncols) * dx, qreal(i / ncols) * dy);
+		if ((i % 8) == 7)
+			pos.rx() += 0.6 * rect.width();
+		nodes.at(i)->setPos(pos);
+		positions.append(pos);
+	}
+
+	::printf("repel: %d nodes (%d overlapping)\n", count, count / 8);
+
+	{ qpwgraph_bench_step step("repel all: scan");
+		foreach (qpwgraph_node *node, nodes)
+			bench_repel_scan(nodes, node); }
+	const QSet<int>& moved1 = bench_repel_moved(nodes, positions, true);
+
+	{ qpwgraph_bench_step step("repel all: grid");
+		canvas.repelOverlappingNodesAll(); }
+	const int noverlaps = bench_repel_overlaps(nodes);
+	const QSet<int>& moved2 = bench_repel_moved(nodes, positions, true);
+
+	::printf("  moved nodes: scan %d, grid %d (%d differ)\n",
+		int(moved1.count()), int(moved2.count()),
+		int((moved1 - moved2).count() + (moved2 - moved1).count()));
+	::printf("  still overlapping: %d nodes\n", noverlaps);
+
+	// One overlapping node dropped in the middle (dragging)...
+	qpwgraph_node *node = nodes.at(qMin(count - 1, (count / 2) | 7));
+
+	{ qpwgraph_bench_step step("repel one: scan");
+		bench_repel_scan(nodes, node); }
+	bench_repel_moved(nodes, positions, true);
+
+	{ qpwgraph_bench_step step("repel one: grid");
+		canvas.repelOverlappingNodes(node); }
+	bench_repel_moved(nodes, positions, true);
+
+	return (!moved1.isEmpty() && moved1 == moved2 && noverlaps == 0);
+}
+
+
+//----------------------------------------------------------------------------
+// Topological ranking: the former depth-first visit of every path (mirrored
+// here on the graph snapshot, with a visit budget, as it is exponential on
+// dense graphs) vs. the linear-time ranking in use, on generated layered
+// graphs with a few feedback (cycle closing) connections.
+
+class qpwgraph_bench_toposort
+{
+public:
+
+	qpwgraph_bench_toposort(const qpwgraph_layout::Graph& graph, qint64 budget)
+		: m_graph(graph), m_visits(0), m_budget(budget)
+	{
+		// Each node outgoing edges, as formerly from its output ports.
+		m_edges.resize(m_graph.nodes.size());
+		for (int k = 0; k < m_graph.edges.size(); ++k)
+			m_edges[m_graph.edges.at(k).node1].append(k);
+	}
+
+	// False when the visit budget is exhausted.
+	bool rank()
+	{
+		const int count = m_graph.nodes.size();
+
+		QList<int> nodes;
+		for (int i = 0; i < count; ++i) {
+			const qpwgraph_layout::Node& n = m_graph.nodes.at(i);
+			if (n.inputs == 0)
+				m_nodeRanks[i] = 0;
+			else
+			if (n.outputs == 0)
+				m_nodeRanks[i] = 2;
+			else
+				m_nodeRanks[i] = 1;
+			nodes.append(i);
+		}
+
+		sortNodesByRank(nodes);
+		m_unvisitedNodes = nodes;
+
+		foreach (int i, nodes) {
+			if (m_graph.nodes.at(i).input_connects == 0)
+				visitNode(QSet<int>(), i);
+		}
+
+		while (!m_unvisitedNodes.isEmpty() && m_visits <= m_budget) {
+			const int initialCount = m_unvisitedNodes.count();
+			visitNode(QSet<int>(), m_unvisitedNodes.first());
+			if (initialCount == m_unvisitedNodes.count())
+				break;
+		}
+
+		int sinkDepth = 2;
+		foreach (int i, nodes) {
+			if (m_graph.nodes.at(i).outputs == 0)
+				sinkDepth = qMax(sinkDepth, m_nodeRanks[i]);
+			else
+				sinkDepth = qMax(sinkDepth, m_nodeRanks[i] + 1);
+		}
+		foreach (int i, nodes) {
+			if (m_graph.nodes.at(i).outputs == 0)
+				m_nodeRanks[i] = qMax(m_nodeRanks[i], sinkDepth);
+		}
+
+		sortNodesByRank(nodes);
+
+		return (m_visits <= m_budget);
+	}
+
+	qint64 visits() const
+		{ return m_visits; }
+
+	int nodeRank(int i) const
+		{ return m_nodeRanks.value(i); }
+
+protected:
+
+	// Children, as formerly gathered on each and every visit.
+	QSet<int> childNodes(int i) const
+	{
+		QSet<int> children;
+		foreach (int k, m_edges.at(i)) {
+			const qpwgraph_layout::Edge& e = m_graph.edges.at(k);
+			if (e.node1 != e.node2)
+				children << e.node2;
+		}
+		return children;
+	}
+
+	void visitNode(const QSet<int>& path, int i)
+	{
+		if (++m_visits > m_budget)
+			return;
+
+		m_unvisitedNodes.removeOne(i);
+
+		QSet<int> newPath(path);
+		newPath += i;
+
+		foreach (int next, childNodes(i)) {
+			if (newPath.contains(next))
+				continue;
+			m_nodeRanks[next] = qMax(m_nodeRanks[i] + 1, m_nodeRanks[next]);
+			visitNode(newPath, next);
+		}
+	}
+
+	// By rank only (the former tie-breakers are left out).
+	void sortNodesByRank(QList<int>& nodes)
+	{
+		std::stable_sort(nodes.begin(), nodes.end(),
+			[this](int i1, int i2)
+				{ return m_nodeRanks.value(i1) < m_nodeRanks.value(i2); });
+	}
+
+private:
+
+	const qpwgraph_layout::Graph& m_graph;
+
+	QVector<QVector<int> > m_edges;
+
+	QList<int> m_unvisitedNodes;
+	QHash<int, int> m_nodeRanks;
+
+	qint64 m_visits;
+	qint64 m_budget;
+};
+
+
+static void bench_toposort_graph (
+	qpwgraph_layout::Graph& graph, int count, bool feedback )
+{
+	// Square-ish layers, each node feeding three nodes of the next
+	// layer (or one further down); every 32nd node also feeds back
+	// into some earlier (but not the first) layer, closing a cycle,
+	// unless acyclic (otherwise the very same graph).
+	const int width = qMax(2, int(qSqrt(qreal(count))));
+	const int nlayers = (count + width - 1) / width;
+
+	QRandomGenerator random(count);
+
+	graph.nodes.resize(count);
+	graph.edges.clear();
+	graph.viewport = QRectF(0.0, 0.0, 1920.0, 1080.0);
+
+	for (int i = 0; i < count; ++i) {
+		qpwgraph_layout::Node& n = graph.nodes[i];
+		const int layer = i / width;
+		n.size = QSizeF(160.0, 80.0);
+		n.name = QString("Node %1").arg(i + 1);
+		n.port_type = qpwgraph_pipewire::audioPortType();
+		n.inputs = (layer > 0 ? 2 : 0);
+		n.outputs = (layer < nlayers - 1 ? 2 : 0);
+		n.ports = n.inputs + n.outputs;
+		n.input_connects = 0;
+	}
+
+	for (int i = 0; i < count; ++i) {
+		const int layer = i / width;
+		if (layer >= nlayers - 1)
+			continue;
+		for (int j = 0; j < 3; ++j) {
+			int layer2 = layer + 1;
+			if (j == 2 && layer2 < nlayers - 1 && random.bounded(4) == 0)
+				++layer2;
+			const int first = layer2 * width;
+			const int last = qMin(count, first + width);
+			qpwgraph_layout::Edge e;
+			e.node1 = i;
+			e.node2 = first + random.bounded(last - first);
+			e.y1 = e.y2 = 40.0;
+			graph.edges.append(e);
+		}
+		if ((i % 32) == 31 && layer > 1) {
+			qpwgraph_layout::Edge e;
+			e.node1 = i;
+			e.node2 = width + random.bounded((layer - 1) * width);
+			e.y1 = e.y2 = 40.0;
+			if (feedback)
+				graph.edges.append(e);
+		}
+	}
+
+	foreach (const qpwgraph_layout::Edge& e, graph.edges) {
+		if (e.node1 != e.node2)
+			++graph.nodes[e.node2].input_connects;
+	}
+}
+
+
+// One graph ranking, both ways: false on any rank mismatch.
+static bool bench_toposort_run (
+	int n, bool cyclic, qint64 budget, int& ncompared )
+{
+	qpwgraph_layout::Graph graph;
+	bench_toposort_graph(graph, n, cyclic);
+
+	QElapsedTimer timer;
+	timer.start();
+	qpwgraph_toposort topo(graph);
+	const QVector<int>& ranks = topo.rank();
+	const double msecs1 = double(timer.nsecsElapsed()) / 1000000.0;
+
+	bool ok = (ranks.count() == n);
+
+	timer.start();
+	qpwgraph_bench_toposort topo2(graph, budget);
+	const bool done = topo2.rank();
+	const double msecs2 = double(timer.nsecsElapsed()) / 1000000.0;
+
+	const char *kind = (cyclic ? "cyclic" : "acyclic");
+	if (done) {
+		::printf("  %8d %8s %8d %14.3f %14.3f %12lld\n",
+			n, kind, int(graph.edges.count()), msecs1, msecs2,
+			(long long) topo2.visits());
+	} else {
+		::printf("  %8d %8s %8d %14.3f %14s %12s\n",
+			n, kind, int(graph.edges.count()), msecs1, "(gave up)", ">budget");
+	}
+
+	// Longest-path layering must agree on acyclic graphs...
+	if (done && !cyclic && ranks.count() == n) {
+		int ndiffs = 0;
+		for (int i = 0; i < n; ++i) {
+			if (ranks.at(i) != topo2.nodeRank(i))
+				++ndiffs;
+		}
+		if (ndiffs > 0) {
+			::printf("  ranks differ: %d nodes\n", ndiffs);
+			ok = false;
+		}
+		++ncompared;
+	}
+
+	return ok;
+}
+
+
+static bool bench_toposort ( int count )
+{
+	// Visit budget for the former ranking, per graph.
+	const qint64 budget = 10000000;
+
+	::printf("toposort: ranking of layered graphs, by node count\n");
+	::printf("  %8s %8s %8s %14s %14s %12s\n",
+		"nodes", "graph", "edges", "linear (ms)", "former (ms)", "visits");
+
+	bool ok = true;
+	int ncompared = 0;
+
+	for (int n = 25; n <= count; n *= 2) {
+		if (!bench_toposort_run(n, false, budget, ncompared))
+			ok = false;
+		if (!bench_toposort_run(n, true, budget, ncompared))
+			ok = false;
+	}
+
+	return ok && (ncompared > 0);
+}
+
+
+//----------------------------------------------------------------------------
+// main -- Run all (or just the named) benchmark cases.
+
+static struct
+{
+	const char *name;
+	bool (*func)(int);
+	int count;
+
+} g_bench_cases[] = {
+
+	{ "patchbay", bench_patchbay, 10000 },
+	{ "objects",  bench_objects,   4096 },
+	{ "classes",  bench_classes,  10000 },
+	{ "sort",     bench_sort,     10000 },
+	{ "repel",    bench_repel,     1000 },
+	{ "toposort", bench_toposort,  1600 },
+
+	{ nullptr, nullptr, 0 }
+};
+
+
+int main ( int argc, char *argv[] )
+{
+	// No display needed, whatsoever.
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
+	QApplication app(argc, argv);
+
+	const QStringList& args = app.arguments();
+	const QString& name = (args.count() > 1 ? args.at(1) : QString());
+	const int count = (args.count() > 2 ? args.at(2).toInt() : 0);
+
+	int ret = 0, ncases = 0;
+
+	for (int i = 0; g_bench_cases[i].name; ++i) {
+		if (!name.isEmpty() && name != g_bench_cases[i].name)
+			continue;
+		const int n = (count > 0 ? count : g_bench_cases[i].count);
+		if (!(*g_bench_cases[i].func)(n)) {
+			::fprintf(stderr, "%s: FAILED.\n", g_bench_cases[i].name);
+			ret = 1;
+		}
+		++ncases;
+	}
+
+	if (ncases == 0) {
+		::fprintf(stderr, "Usage: %s [case [count]]\n", argv[0]);
+		ret = 2;
+	}
+
+	return ret;
+}
+
+
+// end of qpwgraph_bench.cpp
@@ -22,8 +22,9 @@
 #include "qpwgraph_canvas.h"
 
 #include "qpwgraph_connect.h"
+#include "qpwgraph_shadow.h"
 #include "qpwgraph_patchbay.h"
-#include "qpwgraph_toposort.h"
+#include "qpwgraph_layout.h"
 
 #include <QGraphicsScene>
 #include <QRegularExpression>
@@ -36,6 +37,7 @@
 #include <QGraphicsProxyWidget>
 #include <QLineEdit>
 #include <QScrollBar>
+#include <QTimer>
 
 #include <QMouseEvent>
 #include <QWheelEvent>
@@ -48,6 +50,11 @@
 #include <cmath>
 
 
+// Node arrangement animation duration and frame interval (msecs).
+#define ARRANGE_NODES_ANIMATE_MSECS  300
+#define ARRANGE_NODES_ANIMATE_FRAME  15
+
+
 // Local constants.
 static const char *CanvasGroup      = "/GraphCanvas";
 static const char *CanvasRectKey    = "/CanvasRect";
@@ -68,11 +75,14 @@ static const char *PortAliasesGroup = "/GraphPortAliases";
 qpwgraph_canvas::qpwgraph_canvas ( QWidget *parent )
 	: QGraphicsView(parent), m_state(DragNone), m_item(nullptr),
 		m_connect(nullptr), m_port2(nullptr), m_rubberband(nullptr),
-		m_zoom(1.0), m_zoomrange(false), m_gesture(false),
+		m_zoom(1.0), m_zoomrange(false), m_gesture(false), m_simplified(false),
 		m_commands(nullptr), m_settings(nullptr),
 		m_patchbay(nullptr), m_patchbay_edit(false),
 		m_patchbay_autopin(true), m_patchbay_autodisconnect(false),
 		m_selected_nodes(0), m_repel_overlapping_nodes(false),
+		m_layout(nullptr), m_layout_thread(nullptr),
+		m_layout_command(nullptr), m_layout_animate(false),
+		m_layout_timer(nullptr), m_repel_depth(0),
 		m_rename_item(nullptr), m_rename_editor(nullptr), m_renamed(0),
 		m_search_editor(nullptr), m_filter_enabled(false),
 		m_merger_enabled(false)
@@ -123,17 +133,29 @@ qpwgraph_canvas::qpwgraph_canvas ( QWidget *parent )
 	QObject::connect(m_search_editor,
 		SIGNAL(editingFinished()),
 		SLOT(searchEditingFinished()));
+
+	m_layout = new qpwgraph_layout_sugiyama();
+
+	m_layout_timer = new QTimer(this);
+	m_layout_timer->setInterval(ARRANGE_NODES_ANIMATE_FRAME);
+
+	QObject::connect(m_layout_timer,
+		SIGNAL(timeout()),
+		SLOT(arrangeNodesAnimate()));
 }
 
 
 // Destructor.
 qpwgraph_canvas::~qpwgraph_canvas (void)
 {
+	cancelArrangeNodes();
+
 	clear();
 
 	delete m_search_editor;
 	delete m_rename_editor;
 
+	delete m_layout;
 	delete m_patchbay;
 	delete m_commands;
 	delete m_scene;
@@ -171,6 +193,58 @@ qpwgraph_patchbay *qpwgraph_canvas::patchbay (void) const
 }
 
 
+// Node arrangement layout engine (takes ownership).
+void qpwgraph_canvas::setLayoutEngine ( qpwgraph_layout *layout )
+{
+	if (m_layout == layout)
+		return;
+
+	cancelArrangeNodes();
+
+	delete m_layout;
+
+	m_layout = layout;
+}
+
+
+qpwgraph_layout *qpwgraph_canvas::layoutEngine (void) const
+{
+	return m_layout;
+}
+
+
+// Node arrangement animation accessors.
+void qpwgraph_canvas::setArrangeNodesAnimated ( bool on )
+{
+	m_layout_animate = on;
+}
+
+
+bool qpwgraph_canvas::isArrangeNodesAnimated (void) const
+{
+	return m_layout_animate;
+}
+
+
+// Node arrangement (background) status.
+bool qpwgraph_canvas::isArrangingNodes (void) const
+{
+	return (m_layout_thread != nullptr || m_layout_command != nullptr);
+}
+
+
+int qpwgraph_canvas::arrangeNodesProgress (void) const
+{
+	if (m_layout_thread && m_layout)
+		return m_layout->progress();
+	else
+	if (m_layout_command)
+		return 100;
+	else
+		return -1;
+}
+
+
 // Patchbay auto-pin accessors.
 void qpwgraph_canvas::setPatchbayAutoPin ( bool on )
 {
@@ -309,11 +383,17 @@ void qpwgraph_canvas::addItem ( qpwgraph_item *item )
 	if (item->type() != qpwgraph_port::Type) // ports are already in nodes
 		m_scene->addItem(item);
 
+	if (item->type() != qpwgraph_port::Type) // graph has changed...
+		cancelArrangeNodes();
+
 	if (item->type() == qpwgraph_node::Type) {
 		qpwgraph_node *node = static_cast<qpwgraph_node *> (item);
 		if (node) {
+			node->setSimplified(m_simplified);
 			m_nodes.append(node);
 			addNodeKeys(node);
+			if (m_patchbay)
+				m_patchbay->changeNode(node);
 			if (restoreNode(node))
 				emit updated(node);
 			else
@@ -323,8 +403,11 @@ void qpwgraph_canvas::addItem ( qpwgraph_item *item )
 	else
 	if (item->type() == qpwgraph_port::Type) {
 		qpwgraph_port *port = static_cast<qpwgraph_port *> (item);
-		if (port)
+		if (port) {
 			restorePort(port);
+			if (m_patchbay)
+				m_patchbay->changeNode(port->portNode());
+		}
 	}
 	else
 	if (item->type() == qpwgraph_connect::Type) {
@@ -332,6 +415,7 @@ void qpwgraph_canvas::addItem ( qpwgraph_item *item )
 		if (connect) {
 			connect->setDimmed(m_patchbay_edit &&
 				m_patchbay && !m_patchbay->findConnect(connect));
+			changeConnectNodes(connect);
 		}
 	}
 }
@@ -339,8 +423,13 @@ void qpwgraph_canvas::addItem ( qpwgraph_item *item )
 
 void qpwgraph_canvas::removeItem ( qpwgraph_item *item )
 {
+	if (item->type() != qpwgraph_port::Type) // graph is changing...
+		cancelArrangeNodes();
+
 	if (item->type() == qpwgraph_node::Type) {
 		qpwgraph_node *node = static_cast<qpwgraph_node *> (item);
+		if (node && m_patchbay)
+			m_patchbay->changeNode(node);
 		if (node && saveNode(node)) {
 			emit removed(node);
 			node->removePorts();
@@ -352,8 +441,17 @@ void qpwgraph_canvas::removeItem ( qpwgraph_item *item )
 	else
 	if (item->type() == qpwgraph_port::Type) {
 		qpwgraph_port *port = static_cast<qpwgraph_port *> (item);
-		if (port)
+		if (port) {
 			savePort(port);
+			if (m_patchbay)
+				m_patchbay->changeNode(port->portNode());
+		}
+	}
+	else
+	if (item->type() == qpwgraph_connect::Type) {
+		qpwgraph_connect *connect = static_cast<qpwgraph_connect *> (item);
+		if (connect)
+			changeConnectNodes(connect);
 	}
 
 	// Do not remove items from the scene
@@ -363,6 +461,22 @@ void qpwgraph_canvas::removeItem ( qpwgraph_item *item )
 }
 
 
+// Patchbay incremental scan: mark both connection ends as changed.
+void qpwgraph_canvas::changeConnectNodes ( qpwgraph_connect *connect )
+{
+	if (m_patchbay == nullptr)
+		return;
+
+	qpwgraph_port *port1 = connect->port1();
+	if (port1)
+		m_patchbay->changeNode(port1->portNode());
+
+	qpwgraph_port *port2 = connect->port2();
+	if (port2)
+		m_patchbay->changeNode(port2->portNode());
+}
+
+
 // Current item accessor.
 qpwgraph_item *qpwgraph_canvas::currentItem (void) const
 {
@@ -493,6 +607,8 @@ void qpwgraph_canvas::setZoom ( qreal zoom )
 
 	m_zoom = zoom;
 
+	updateSimplified();
+
 	emit changed();
 }
 
@@ -515,6 +631,53 @@ bool qpwgraph_canvas::isZoomRange (void) const
 }
 
 
+// Level-of-detail zoom thresholds (simplified drawing below).
+void qpwgraph_canvas::setSimplifyNodesZoom ( qreal zoom )
+{
+	qpwgraph_node::setSimplifyZoom(zoom);
+
+	updateSimplified();
+
+	m_scene->update();
+}
+
+
+qreal qpwgraph_canvas::simplifyNodesZoom (void) const
+{
+	return qpwgraph_node::simplifyZoom();
+}
+
+
+void qpwgraph_canvas::setSimplifyConnectsZoom ( qreal zoom )
+{
+	qpwgraph_connect::setSimplifyZoom(zoom);
+
+	m_scene->update();
+}
+
+
+qreal qpwgraph_canvas::simplifyConnectsZoom (void) const
+{
+	return qpwgraph_connect::simplifyZoom();
+}
+
+
+// Node drop-shadows accessors.
+void qpwgraph_canvas::setNodeShadows ( bool on )
+{
+	qpwgraph_shadow::setShadowsEnabled(on);
+
+	foreach (qpwgraph_node *node, m_nodes)
+		node->updateShadow();
+}
+
+
+bool qpwgraph_canvas::isNodeShadows (void) const
+{
+	return qpwgraph_shadow::isShadowsEnabled();
+}
+
+
 // Clean-up all un-marked nodes...
 void qpwgraph_canvas::resetNodes ( uint node_type )
 {
@@ -540,6 +703,8 @@ void qpwgraph_canvas::resetNodes ( uint node_type )
 
 void qpwgraph_canvas::clearNodes ( uint node_type )
 {
+	cancelArrangeNodes();
+
 	QList<qpwgraph_node *> nodes;
 
 	foreach (qpwgraph_node *node, m_nodes) {
@@ -586,6 +751,18 @@ QList<qpwgraph_node *> qpwgraph_canvas::findNodes (
 
 QList<qpwgraph_node *> qpwgraph_canvas::findNodes (
 	const QString& name, qpwgraph_item::Mode mode, uint type ) const
+{
+	// Never interned, never named...
+	const qpwgraph_atom& atom = qpwgraph_atom::lookup(name);
+	if (atom.isNull())
+		return QList<qpwgraph_node *> ();
+
+	return findNodes(qpwgraph_node::NodeNameKey(atom, mode, type));
+}
+
+
+QList<qpwgraph_node *> qpwgraph_canvas::findNodes (
+	const qpwgraph_atom& name, qpwgraph_item::Mode mode, uint type ) const
 {
 	return findNodes(qpwgraph_node::NodeNameKey(name, mode, type));
 }
@@ -607,24 +784,44 @@ void qpwgraph_canvas::releaseNode ( qpwgraph_node *node )
 }
 
 
+// Node-list accessor.
+const QList<qpwgraph_node *>& qpwgraph_canvas::nodes (void) const
+{
+	return m_nodes;
+}
+
+
 // Port (dis)connections dispatcher.
 void qpwgraph_canvas::emitConnectPorts (
 	qpwgraph_port *port1, qpwgraph_port *port2, bool is_connect )
 {
-	if (m_patchbay_edit && !m_patchbay_autopin && is_connect) {
-		qpwgraph_connect *connect = port1->findConnect(port2);
-		if (connect)
-			connect->setDimmed(true);
-	}
+	qpwgraph_port::Pairs pairs;
+	pairs.append(qpwgraph_port::Pair(port1, port2));
+
+	emitConnectPorts(pairs, is_connect);
+}
 
-	if (m_patchbay && (m_patchbay_autopin
-		|| (!is_connect && m_patchbay->isActivated())))
-		m_patchbay->connectPorts(port1, port2, is_connect);
+
+void qpwgraph_canvas::emitConnectPorts (
+	const qpwgraph_port::Pairs& pairs, bool is_connect )
+{
+	foreach (const qpwgraph_port::Pair& pair, pairs) {
+		qpwgraph_port *port1 = pair.first;
+		qpwgraph_port *port2 = pair.second;
+		if (m_patchbay_edit && !m_patchbay_autopin && is_connect) {
+			qpwgraph_connect *connect = port1->findConnect(port2);
+			if (connect)
+				connect->setDimmed(true);
+		}
+		if (m_patchbay && (m_patchbay_autopin
+			|| (!is_connect && m_patchbay->isActivated())))
+			m_patchbay->connectPorts(port1, port2, is_connect);
+	}
 
 	if (is_connect)
-		emitConnected(port1, port2);
+		emitConnected(pairs);
 	else
-		emitDisconnected(port1, port2);
+		emitDisconnected(pairs);
 }
 
 
@@ -632,14 +829,59 @@ void qpwgraph_canvas::emitConnectPorts (
 void qpwgraph_canvas::emitConnected (
 	qpwgraph_port *port1, qpwgraph_port *port2 )
 {
-	emit connected(port1, port2);
+	qpwgraph_port::Pairs pairs;
+	pairs.append(qpwgraph_port::Pair(port1, port2));
+
+	emitConnected(pairs);
 }
 
 
 void qpwgraph_canvas::emitDisconnected (
 	qpwgraph_port *port1, qpwgraph_port *port2 )
 {
-	emit disconnected(port1, port2);
+	qpwgraph_port::Pairs pairs;
+	pairs.append(qpwgraph_port::Pair(port1, port2));
+
+	emitDisconnected(pairs);
+}
+
+
+void qpwgraph_canvas::emitConnected ( const qpwgraph_port::Pairs& pairs )
+{
+	if (!pairs.isEmpty())
+		emit connected(pairs);
+}
+
+
+void qpwgraph_canvas::emitDisconnected ( const qpwgraph_port::Pairs& pairs )
+{
+	if (!pairs.isEmpty())
+		emit disconnected(pairs);
+}
+
+
+// Port (dis)connection command (batched, undoable).
+void qpwgraph_canvas::connectPortsBatch (
+	const qpwgraph_port::Pairs& pairs, bool is_connect )
+{
+	qpwgraph_port::Pairs pairs2;
+
+	foreach (const qpwgraph_port::Pair& pair, pairs) {
+		qpwgraph_port *port1 = pair.first;
+		qpwgraph_port *port2 = pair.second;
+		if (port1 == nullptr || port2 == nullptr)
+			continue;
+		if (port1->isOutput())
+			pairs2.append(qpwgraph_port::Pair(port1, port2));
+		else
+			pairs2.append(qpwgraph_port::Pair(port2, port1));
+	}
+
+	if (pairs2.isEmpty())
+		return;
+
+	m_commands->push(
+		new qpwgraph_connect_command(this, pairs2, is_connect));
 }
 
 
@@ -1101,7 +1343,7 @@ void qpwgraph_canvas::connectItems (void)
 	QListIterator<qpwgraph_port *> iter1(outs);
 	QListIterator<qpwgraph_port *> iter2(ins);
 
-	m_commands->beginMacro(tr("Connect"));
+	qpwgraph_port::Pairs pairs;
 
 	const int nports = qMax(outs.count(), ins.count());
 	for (int n = 0; n < nports; ++n) {
@@ -1124,12 +1366,13 @@ void qpwgraph_canvas::connectItems (void)
 			}
 			port2 = iter2.next();
 		}
-		// Submit command; notify eventual observers...
+		// Collect for command; notify eventual observers...
 		if (!wrapped && port1 && port2 && port1->portNode() != port2->portNode())
-			connectPorts(port1, port2, true);
+			pairs.append(qpwgraph_port::Pair(port1, port2));
 	}
 
-	m_commands->endMacro();
+	// Submit command, all in one go...
+	connectPortsBatch(pairs, true);
 }
 
 
@@ -1174,17 +1417,18 @@ void qpwgraph_canvas::disconnectItems (void)
 
 	m_item = nullptr;
 
-	m_commands->beginMacro(tr("Disconnect"));
+	qpwgraph_port::Pairs pairs;
 
 	foreach (qpwgraph_connect *connect, connects) {
-		// Submit command; notify eventual observers...
+		// Collect for command; notify eventual observers...
 		qpwgraph_port *port1 = connect->port1();
 		qpwgraph_port *port2 = connect->port2();
 		if (port1 && port2)
-			connectPorts(port1, port2, false);
+			pairs.append(qpwgraph_port::Pair(port1, port2));
 	}
 
-	m_commands->endMacro();
+	// Submit command, all in one go...
+	connectPortsBatch(pairs, false);
 }
 
 
@@ -1420,10 +1664,26 @@ void qpwgraph_canvas::zoomFitRange ( const QRectF& range_rect )
 		m_zoom = zoom;
 	}
 
+	updateSimplified();
+
 	emit changed();
 }
 
 
+// Level-of-detail (simplified nodes) updater.
+void qpwgraph_canvas::updateSimplified (void)
+{
+	const bool simplified = (m_zoom < qpwgraph_node::simplifyZoom());
+	if (m_simplified == simplified)
+		return;
+
+	m_simplified = simplified;
+
+	foreach (qpwgraph_node *node, m_nodes)
+		node->setSimplified(m_simplified);
+}
+
+
 // Graph node/port state methods.
 bool qpwgraph_canvas::restoreNode ( qpwgraph_node *node )
 {
@@ -1902,6 +2162,15 @@ void qpwgraph_canvas::repelOverlappingNodes ( qpwgraph_node *node,
 {
 	const qreal MIN_NODE_GAP = 8.0f;
 
+	// (Re)build the spatial index, on the outermost pass only...
+	if (m_repel_depth < 1) {
+		m_repel_grid.clear();
+		foreach (qpwgraph_node *node2, m_nodes)
+			m_repel_grid.insert(node2);
+	}
+
+	++m_repel_depth;
+
 	node->setMarked(true);
 
 	QRectF rect1 = node->sceneBoundingRect();
@@ -1909,7 +2178,8 @@ void qpwgraph_canvas::repelOverlappingNodes ( qpwgraph_node *node,
 		-2.0 * MIN_NODE_GAP, -MIN_NODE_GAP,
 		+2.0 * MIN_NODE_GAP, +MIN_NODE_GAP);
 
-	foreach (qpwgraph_node *node2, m_nodes) {
+	// Only the nearby nodes are candidates...
+	foreach (qpwgraph_node *node2, m_repel_grid.nodes(rect1)) {
 		if (node2->isMarked())
 			continue;
 		const QPointF& pos1
@@ -1955,6 +2225,7 @@ void qpwgraph_canvas::repelOverlappingNodes ( qpwgraph_node *node,
 			}
 			// Repel this node...
 			node2->setPos(pos2);
+			m_repel_grid.update(node2);
 			// Add this node for undo/redo...
 			if (move_command)
 				move_command->addItem(node2, pos1, pos2);
@@ -1964,18 +2235,39 @@ void qpwgraph_canvas::repelOverlappingNodes ( qpwgraph_node *node,
 	}
 
 	node->setMarked(false);
+
+	if (--m_repel_depth < 1)
+		m_repel_grid.clear();
 }
 
 
-void qpwgraph_canvas::repelOverlappingNodesAll (
+void qpwgraph_canvas::repelOverlappingNodes (
+	const QList<qpwgraph_node *>& nodes,
 	qpwgraph_move_command *move_command )
 {
+	// One single spatial index for them all...
+	m_repel_grid.clear();
 	foreach (qpwgraph_node *node, m_nodes)
+		m_repel_grid.insert(node);
+
+	++m_repel_depth;
+
+	foreach (qpwgraph_node *node, nodes)
 		repelOverlappingNodes(node, move_command);
+
+	if (--m_repel_depth < 1)
+		m_repel_grid.clear();
 }
 
 
-// Node rearrangement by topological sort.
+void qpwgraph_canvas::repelOverlappingNodesAll (
+	qpwgraph_move_command *move_command )
+{
+	repelOverlappingNodes(m_nodes, move_command);
+}
+
+
+// Node rearrangement by the current layout engine.
 //
 void qpwgraph_canvas::arrangeNodes (void)
 {
@@ -1988,22 +2280,139 @@ void qpwgraph_canvas::arrangeNodes (void)
 		}
 	}
 
-	if (nodes.size() < 2)
+	if (nodes.size() < 2 || m_layout == nullptr)
 		return;
 
-	qpwgraph_toposort topo(nodes);
-	auto newPositions = topo.arrange(QGraphicsView::viewport()->rect());
+	// Only one at a time...
+	cancelArrangeNodes();
+
+	// Lay out a snapshot of the selected nodes, in the background...
+	m_layout_nodes = nodes;
+	m_layout_thread = new qpwgraph_layout_thread(m_layout,
+		qpwgraph_layout::snapshot(nodes, QGraphicsView::viewport()->rect()), this);
+
+	QObject::connect(m_layout_thread,
+		SIGNAL(finished()),
+		SLOT(arrangeNodesFinished()));
+
+	m_layout_thread->start();
+}
+
+
+// Cancel (or finish) any pending node arrangement.
+void qpwgraph_canvas::cancelArrangeNodes (void)
+{
+	// Still computing? discard...
+	if (m_layout_thread) {
+		m_layout_thread->cancel();
+		m_layout_thread->deleteLater();
+		m_layout_thread = nullptr;
+		m_layout_nodes.clear();
+	}
+
+	// Still animating? finish...
+	if (m_layout_command)
+		arrangeNodesCommit();
+}
+
+
+// Node arrangement slots.
+void qpwgraph_canvas::arrangeNodesFinished (void)
+{
+	qpwgraph_layout_thread *layout_thread = m_layout_thread;
+	if (layout_thread == nullptr
+		|| layout_thread != sender()
+		|| !layout_thread->isFinished())
+		return;
+
+	const qpwgraph_layout::Positions positions = layout_thread->positions();
+
+	layout_thread->deleteLater();
+	m_layout_thread = nullptr;
+
+	const QList<qpwgraph_node *> nodes = m_layout_nodes;
+	m_layout_nodes.clear();
+
+	const int nnodes = nodes.size();
+	if (positions.size() != nnodes)
+		return;
+
+	m_layout_pos1.clear();
+	m_layout_pos2.clear();
+
+	for (int i = 0; i < nnodes; ++i) {
+		qpwgraph_node *node = nodes.at(i);
+		m_layout_pos1.insert(node, node->pos());
+		m_layout_pos2.insert(node, positions.at(i));
+	}
+
+	// All in one single undoable command...
+	m_layout_command = new qpwgraph_move_command(this, m_layout_pos2);
 
-	qpwgraph_move_command *mc = new qpwgraph_move_command(this, newPositions);
+	if (m_layout_animate) {
+		m_layout_elapsed.start();
+		m_layout_timer->start();
+	} else {
+		arrangeNodesCommit();
+	}
+}
 
-	foreach (qpwgraph_node *n, newPositions.keys()) {
-		n->setPos(newPositions.value(n));
+
+void qpwgraph_canvas::arrangeNodesAnimate (void)
+{
+	const qreal t = qreal(m_layout_elapsed.elapsed())
+		/ qreal(ARRANGE_NODES_ANIMATE_MSECS);
+	if (t >= 1.0 || m_layout_command == nullptr) {
+		arrangeNodesCommit();
+		return;
 	}
 
-	if (isRepelOverlappingNodes()) {
-		foreach (qpwgraph_node *node, nodes)
-			repelOverlappingNodes(node, mc);
+	// Ease in-out (smooth-step) interpolation...
+	const qreal s = t * t * (3.0 - 2.0 * t);
+
+	QHash<qpwgraph_node *, QPointF>::ConstIterator iter
+		= m_layout_pos2.constBegin();
+	const QHash<qpwgraph_node *, QPointF>::ConstIterator& iter_end
+		= m_layout_pos2.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		qpwgraph_node *node = iter.key();
+		const QPointF& pos1 = m_layout_pos1.value(node);
+		node->setPos(pos1 + (iter.value() - pos1) * s);
 	}
+}
+
+
+// Node arrangement final stage (one single move command).
+void qpwgraph_canvas::arrangeNodesCommit (void)
+{
+	m_layout_timer->stop();
+
+	qpwgraph_move_command *mc = m_layout_command;
+	m_layout_command = nullptr;
+
+	if (mc == nullptr)
+		return;
+
+	QList<qpwgraph_node *> nodes;
+
+	QHash<qpwgraph_node *, QPointF>::ConstIterator iter
+		= m_layout_pos2.constBegin();
+	const QHash<qpwgraph_node *, QPointF>::ConstIterator& iter_end
+		= m_layout_pos2.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		qpwgraph_node *node = iter.key();
+		node->setPos(iter.value());
+		nodes.append(node);
+	}
+
+	m_layout_pos1.clear();
+	m_layout_pos2.clear();
+
+	if (isRepelOverlappingNodes())
+		repelOverlappingNodes(nodes, mc);
+
+	foreach (qpwgraph_node *node, nodes)
+		saveNode(node);
 
 	m_commands->push(mc);
 
@@ -25,8 +25,10 @@
 #include <QGraphicsView>
 
 #include "qpwgraph_command.h"
+#include "qpwgraph_grid.h"
 
 #include <QHash>
+#include <QElapsedTimer>
 
 
 // Forward decls.
@@ -47,6 +49,10 @@ class QGestureEvent;
 class QPinchGesture;
 
 class qpwgraph_patchbay;
+class qpwgraph_layout;
+class qpwgraph_layout_thread;
+
+class QTimer;
 
 
 // Define if cleanup of legacy node names is needed (v0.5.0)...
@@ -77,6 +83,21 @@ public:
 
 	qpwgraph_patchbay *patchbay() const;
 
+	// Node arrangement layout engine (takes ownership).
+	void setLayoutEngine(qpwgraph_layout *layout);
+	qpwgraph_layout *layoutEngine() const;
+
+	// Node arrangement animation accessors.
+	void setArrangeNodesAnimated(bool on);
+	bool isArrangeNodesAnimated() const;
+
+	// Node arrangement (background) status.
+	bool isArrangingNodes() const;
+	int arrangeNodesProgress() const;
+
+	// Cancel (or finish) any pending node arrangement.
+	void cancelArrangeNodes();
+
 	// Patchbay auto-pin accessors.
 	void setPatchbayAutoPin(bool on);
 	bool isPatchbayAutoPin() const;
@@ -123,6 +144,17 @@ public:
 	void setZoomRange(bool zoomrange);
 	bool isZoomRange() const;
 
+	// Level-of-detail zoom thresholds (simplified drawing below).
+	void setSimplifyNodesZoom(qreal zoom);
+	qreal simplifyNodesZoom() const;
+
+	void setSimplifyConnectsZoom(qreal zoom);
+	qreal simplifyConnectsZoom() const;
+
+	// Node drop-shadows accessors.
+	void setNodeShadows(bool on);
+	bool isNodeShadows() const;
+
 	void centerView(bool showSelected);
 
 	// Clean-up all un-marked nodes...
@@ -139,20 +171,34 @@ public:
 		const qpwgraph_node::NodeNameKey& name_key) const;
 	QList<qpwgraph_node *> findNodes(
 		const QString& name, qpwgraph_item::Mode mode, uint type = 0) const;
+	QList<qpwgraph_node *> findNodes(
+		const qpwgraph_atom& name, qpwgraph_item::Mode mode, uint type = 0) const;
 
 	void releaseNode(qpwgraph_node *node);
 
+	// Node-list accessor.
+	const QList<qpwgraph_node *>& nodes() const;
+
 	// Whether it's in the middle of something...
 	bool isBusy() const;
 
 	// Port (dis)connections dispatcher.
 	void emitConnectPorts(
 		qpwgraph_port *port1, qpwgraph_port *port2, bool is_connect);
+	void emitConnectPorts(
+		const qpwgraph_port::Pairs& pairs, bool is_connect);
 
 	// Port (dis)connections notifiers.
 	void emitConnected(qpwgraph_port *port1, qpwgraph_port *port2);
 	void emitDisconnected(qpwgraph_port *port1, qpwgraph_port *port2);
 
+	void emitConnected(const qpwgraph_port::Pairs& pairs);
+	void emitDisconnected(const qpwgraph_port::Pairs& pairs);
+
+	// Port (dis)connection command (batched, undoable).
+	void connectPortsBatch(
+		const qpwgraph_port::Pairs& pairs, bool is_connect);
+
 	// Rename notifier.
 	void emitRenamed(qpwgraph_item *item, const QString& name);
 
@@ -176,6 +222,8 @@ public:
 	void repelOverlappingNodes(qpwgraph_node *node,
 		qpwgraph_move_command *move_command = nullptr,
 		const QPointF& delta = QPointF());
+	void repelOverlappingNodes(const QList<qpwgraph_node *>& nodes,
+		qpwgraph_move_command *move_command = nullptr);
 	void repelOverlappingNodesAll(
 		qpwgraph_move_command *move_command = nullptr);
 
@@ -228,8 +276,8 @@ signals:
 	void removed(qpwgraph_node *node);
 
 	// Port (dis)connection notifications.
-	void connected(qpwgraph_port *port1, qpwgraph_port *port2);
-	void disconnected(qpwgraph_port *port1, qpwgraph_port *port2);
+	void connected(const qpwgraph_port::Pairs& pairs);
+	void disconnected(const qpwgraph_port::Pairs& pairs);
 
 	void connected(qpwgraph_connect *connect);
 
@@ -278,8 +326,15 @@ protected slots:
 	void searchTextChanged(const QString&);
 	void searchEditingFinished();
 
+	// Node arrangement slots.
+	void arrangeNodesFinished();
+	void arrangeNodesAnimate();
+
 protected:
 
+	// Node arrangement final stage (one single move command).
+	void arrangeNodesCommit();
+
 	// Item finder (internal).
 	qpwgraph_item *itemAt(const QPointF& pos) const;
 
@@ -316,6 +371,12 @@ protected:
 	// Zoom in rectangle range.
 	void zoomFitRange(const QRectF& range_rect);
 
+	// Level-of-detail (simplified nodes) updater.
+	void updateSimplified();
+
+	// Patchbay incremental scan: mark both connection ends as changed.
+	void changeConnectNodes(qpwgraph_connect *connect);
+
 	// Update editors position and size.
 	void updateRenameEditor();
 	void updateSearchEditor();
@@ -349,6 +410,7 @@ private:
 	qreal             m_zoom;
 	bool              m_zoomrange;
 	bool              m_gesture;
+	bool              m_simplified;
 
 	qpwgraph_node::NodeIds   m_node_ids;
 	qpwgraph_node::NodeNames m_node_names;
@@ -367,6 +429,25 @@ private:
 
 	bool m_repel_overlapping_nodes;
 
+	// Node arrangement layout engine.
+	qpwgraph_layout *m_layout;
+
+	// Node arrangement (background) state.
+	qpwgraph_layout_thread *m_layout_thread;
+	QList<qpwgraph_node *>  m_layout_nodes;
+	qpwgraph_move_command  *m_layout_command;
+
+	bool          m_layout_animate;
+	QTimer       *m_layout_timer;
+	QElapsedTimer m_layout_elapsed;
+
+	QHash<qpwgraph_node *, QPointF> m_layout_pos1;
+	QHash<qpwgraph_node *, QPointF> m_layout_pos2;
+
+	// Repel overlapping nodes spatial index (per pass).
+	qpwgraph_grid m_repel_grid;
+	int m_repel_depth;
+
 	// Graph port colors.
 	QHash<uint, QColor> m_port_colors;
 
@@ -51,12 +51,25 @@ void qpwgraph_command::redo (void)
 //----------------------------------------------------------------------------
 // qpwgraph_connect_command -- Connect graph command pattern
 
-// Constructor.
+// Constructors.
 qpwgraph_connect_command::qpwgraph_connect_command ( qpwgraph_canvas *canvas,
 	qpwgraph_port *port1, qpwgraph_port *port2, bool is_connect,
-	qpwgraph_command *parent ) : qpwgraph_command(canvas, parent),
-		m_item(port1, port2, is_connect)
+	qpwgraph_command *parent ) : qpwgraph_command(canvas, parent)
+{
+	m_items.append(Item(port1, port2, is_connect));
+}
+
+
+qpwgraph_connect_command::qpwgraph_connect_command ( qpwgraph_canvas *canvas,
+	const qpwgraph_port::Pairs& pairs, bool is_connect,
+	qpwgraph_command *parent ) : qpwgraph_command(canvas, parent)
 {
+	qpwgraph_command::setText(is_connect
+		? QObject::tr("Connect")
+		: QObject::tr("Disconnect"));
+
+	foreach (const qpwgraph_port::Pair& pair, pairs)
+		m_items.append(Item(pair.first, pair.second, is_connect));
 }
 
 
@@ -67,51 +80,64 @@ bool qpwgraph_connect_command::execute ( bool is_undo )
 	if (canvas == nullptr)
 		return false;
 
-	qpwgraph_node *node1
-		= canvas->findNode(
-			m_item.addr1.node_id,
-			qpwgraph_item::Output,
-			m_item.addr1.node_type);
-	if (node1 == nullptr)
-		node1 = canvas->findNode(
-			m_item.addr1.node_id,
-			qpwgraph_item::Duplex,
-			m_item.addr1.node_type);
-	if (node1 == nullptr)
-		return false;
-
-	qpwgraph_port *port1
-		= node1->findPort(
-			m_item.addr1.port_id,
-			qpwgraph_item::Output,
-			m_item.addr1.port_type);
-	if (port1 == nullptr)
-		return false;
-
-	qpwgraph_node *node2
-		= canvas->findNode(
-			m_item.addr2.node_id,
-			qpwgraph_item::Input,
-			m_item.addr2.node_type);
-	if (node2 == nullptr)
-		node2 = canvas->findNode(
-			m_item.addr2.node_id,
-			qpwgraph_item::Duplex,
-			m_item.addr2.node_type);
-	if (node2 == nullptr)
-		return false;
+	qpwgraph_port::Pairs connects;
+	qpwgraph_port::Pairs disconnects;
+
+	foreach (const Item& item, m_items) {
+		qpwgraph_node *node1
+			= canvas->findNode(
+				item.addr1.node_id,
+				qpwgraph_item::Output,
+				item.addr1.node_type);
+		if (node1 == nullptr)
+			node1 = canvas->findNode(
+				item.addr1.node_id,
+				qpwgraph_item::Duplex,
+				item.addr1.node_type);
+		if (node1 == nullptr)
+			continue;
+		qpwgraph_port *port1
+			= node1->findPort(
+				item.addr1.port_id,
+				qpwgraph_item::Output,
+				item.addr1.port_type);
+		if (port1 == nullptr)
+			continue;
+		qpwgraph_node *node2
+			= canvas->findNode(
+				item.addr2.node_id,
+				qpwgraph_item::Input,
+				item.addr2.node_type);
+		if (node2 == nullptr)
+			node2 = canvas->findNode(
+				item.addr2.node_id,
+				qpwgraph_item::Duplex,
+				item.addr2.node_type);
+		if (node2 == nullptr)
+			continue;
+		qpwgraph_port *port2
+			= node2->findPort(
+				item.addr2.port_id,
+				qpwgraph_item::Input,
+				item.addr2.port_type);
+		if (port2 == nullptr)
+			continue;
+		const bool is_connect
+			= (item.is_connect() && !is_undo) || (!item.is_connect() && is_undo);
+		if (is_connect)
+			connects.append(qpwgraph_port::Pair(port1, port2));
+		else
+			disconnects.append(qpwgraph_port::Pair(port1, port2));
+	}
 
-	qpwgraph_port *port2
-		= node2->findPort(
-			m_item.addr2.port_id,
-			qpwgraph_item::Input,
-			m_item.addr2.port_type);
-	if (port2 == nullptr)
+	if (connects.isEmpty() && disconnects.isEmpty())
 		return false;
 
-	const bool is_connect
-		= (m_item.is_connect() && !is_undo) || (!m_item.is_connect() && is_undo);
-	canvas->emitConnectPorts(port1, port2, is_connect);
+	// Dispatch all in one go...
+	if (!disconnects.isEmpty())
+		canvas->emitConnectPorts(disconnects, false);
+	if (!connects.isEmpty())
+		canvas->emitConnectPorts(connects, true);
 
 	return true;
 }
@@ -143,10 +169,8 @@ qpwgraph_move_command::qpwgraph_move_command ( qpwgraph_canvas *canvas,
 			canvas->saveNode(node);
 	}
 
-	if (canvas && canvas->isRepelOverlappingNodes()) {
-		foreach (qpwgraph_node *node, nodes)
-			canvas->repelOverlappingNodes(node, this);
-	}
+	if (canvas && canvas->isRepelOverlappingNodes())
+		canvas->repelOverlappingNodes(nodes, this);
 }
 
 
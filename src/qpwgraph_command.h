@@ -68,11 +68,15 @@ class qpwgraph_connect_command : public qpwgraph_command
 {
 public:
 
-	// Constructor.
+	// Constructors.
 	qpwgraph_connect_command(qpwgraph_canvas *canvas,
 		qpwgraph_port *port1, qpwgraph_port *port2,
 		bool is_connect, qpwgraph_command *parent = nullptr);
 
+	qpwgraph_connect_command(qpwgraph_canvas *canvas,
+		const qpwgraph_port::Pairs& pairs,
+		bool is_connect, qpwgraph_command *parent = nullptr);
+
 protected:
 
 	// Command item address
@@ -132,7 +136,7 @@ protected:
 private:
 
 	// Command arguments.
-	Item m_item;
+	QList<Item> m_items;
 };
 
 
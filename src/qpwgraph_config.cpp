@@ -46,6 +46,11 @@ static const char *ViewSortTypeKey  = "/SortType";
 static const char *ViewSortOrderKey = "/SortOrder";
 static const char *ViewRepelOverlappingNodesKey = "/RepelOverlappingNodes";
 static const char *ViewConnectThroughNodesKey = "/ConnectThroughNodes";
+static const char *ViewRefreshDelayKey = "/RefreshDelay";
+static const char *ViewArrangeNodesAnimatedKey = "/ArrangeNodesAnimated";
+static const char *ViewSimplifyNodesZoomKey = "/SimplifyNodesZoom";
+static const char *ViewSimplifyConnectsZoomKey = "/SimplifyConnectsZoom";
+static const char *ViewNodeShadowsKey = "/NodeShadows";
 
 static const char *PatchbayGroup    = "/Patchbay";
 static const char *PatchbayDirKey   = "/Dir";
@@ -104,6 +109,11 @@ qpwgraph_config::qpwgraph_config ( QSettings *settings, bool owner )
 		m_sorttype(0), m_sortorder(0),
 		m_repelnodes(false),
 		m_cthrunodes(false),
+		m_refresh_delay(30),
+		m_arrange_animated(false),
+		m_simplify_nodes_zoom(50),
+		m_simplify_connects_zoom(30),
+		m_node_shadows(true),
 		m_patchbay_toolbar(false),
 		m_patchbay_activated(false),
 		m_patchbay_exclusive(false),
@@ -266,6 +276,66 @@ bool qpwgraph_config::isConnectThroughNodes (void) const
 }
 
 
+void qpwgraph_config::setRefreshDelay ( int refresh_delay )
+{
+	m_refresh_delay = refresh_delay;
+}
+
+
+int qpwgraph_config::refreshDelay (void) const
+{
+	return m_refresh_delay;
+}
+
+
+void qpwgraph_config::setArrangeNodesAnimated ( bool arrange_animated )
+{
+	m_arrange_animated = arrange_animated;
+}
+
+
+bool qpwgraph_config::isArrangeNodesAnimated (void) const
+{
+	return m_arrange_animated;
+}
+
+
+void qpwgraph_config::setSimplifyNodesZoom ( int simplify_zoom )
+{
+	m_simplify_nodes_zoom = simplify_zoom;
+}
+
+
+int qpwgraph_config::simplifyNodesZoom (void) const
+{
+	return m_simplify_nodes_zoom;
+}
+
+
+void qpwgraph_config::setSimplifyConnectsZoom ( int simplify_zoom )
+{
+	m_simplify_connects_zoom = simplify_zoom;
+}
+
+
+int qpwgraph_config::simplifyConnectsZoom (void) const
+{
+	return m_simplify_connects_zoom;
+}
+
+
+void qpwgraph_config::setNodeShadows ( bool node_shadows )
+{
+	m_node_shadows = node_shadows;
+}
+
+
+bool qpwgraph_config::isNodeShadows (void) const
+{
+	return m_node_shadows;
+}
+
+
 void qpwgraph_config::setPatchbayToolbar ( bool toolbar )
 {
 	m_patchbay_toolbar = toolbar;
@@ -616,6 +686,11 @@ bool qpwgraph_config::restoreState ( QMainWindow *widget )
 	m_sortorder = m_settings->value(ViewSortOrderKey, 0).toInt();
 	m_repelnodes = m_settings->value(ViewRepelOverlappingNodesKey, false).toBool();
 	m_cthrunodes = m_settings->value(ViewConnectThroughNodesKey, false).toBool();
+	m_refresh_delay = m_settings->value(ViewRefreshDelayKey, 30).toInt();
+	m_arrange_animated = m_settings->value(ViewArrangeNodesAnimatedKey, false).toBool();
+	m_simplify_nodes_zoom = m_settings->value(ViewSimplifyNodesZoomKey, 50).toInt();
+	m_simplify_connects_zoom = m_settings->value(ViewSimplifyConnectsZoomKey, 30).toInt();
+	m_node_shadows = m_settings->value(ViewNodeShadowsKey, true).toBool();
 	m_settings->endGroup();
 
 	m_settings->beginGroup(GraphGeometryGroup);
@@ -721,6 +796,11 @@ bool qpwgraph_config::saveState ( QMainWindow *widget ) const
 	m_settings->setValue(ViewSortOrderKey, m_sortorder);
 	m_settings->setValue(ViewRepelOverlappingNodesKey, m_repelnodes);
 	m_settings->setValue(ViewConnectThroughNodesKey, m_cthrunodes);
+	m_settings->setValue(ViewRefreshDelayKey, m_refresh_delay);
+	m_settings->setValue(ViewArrangeNodesAnimatedKey, m_arrange_animated);
+	m_settings->setValue(ViewSimplifyNodesZoomKey, m_simplify_nodes_zoom);
+	m_settings->setValue(ViewSimplifyConnectsZoomKey, m_simplify_connects_zoom);
+	m_settings->setValue(ViewNodeShadowsKey, m_node_shadows);
 	m_settings->endGroup();
 
 	m_settings->beginGroup(GraphGeometryGroup);
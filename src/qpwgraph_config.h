@@ -81,6 +81,21 @@ public:
 	void setConnectThroughNodes(bool cthrunodes);
 	bool isConnectThroughNodes() const;
 
+	void setRefreshDelay(int refresh_delay);
+	int refreshDelay() const;
+
+	void setArrangeNodesAnimated(bool arrange_animated);
+	bool isArrangeNodesAnimated() const;
+
+	void setSimplifyNodesZoom(int simplify_zoom);
+	int simplifyNodesZoom() const;
+
+	void setSimplifyConnectsZoom(int simplify_zoom);
+	int simplifyConnectsZoom() const;
+
+	void setNodeShadows(bool node_shadows);
+	bool isNodeShadows() const;
+
 	void setPatchbayToolbar(bool toolbar);
 	bool isPatchbayToolbar() const;
 
@@ -183,6 +198,14 @@ private:
 	bool        m_repelnodes;
 	bool        m_cthrunodes;
 
+	int         m_refresh_delay;
+	bool        m_arrange_animated;
+
+	int         m_simplify_nodes_zoom;
+	int         m_simplify_connects_zoom;
+
+	bool        m_node_shadows;
+
 	bool        m_patchbay_toolbar;
 	QString     m_patchbay_dir;
 	QString     m_patchbay_path;
@@ -25,6 +25,8 @@
 
 #include <QGraphicsScene>
 
+#include <QTimer>
+
 #include <QStyleOptionGraphicsItem>
 
 #include <QPainter>
@@ -42,7 +44,8 @@
 
 // Constructor.
 qpwgraph_connect::qpwgraph_connect (void)
-	: qpwgraph_item(nullptr), m_port1(nullptr), m_port2(nullptr), m_dimmed(false)
+	: qpwgraph_item(nullptr), m_port1(nullptr), m_port2(nullptr), m_dimmed(false),
+		m_shape_dirty(true), m_dirty_item(this)
 {
 	QGraphicsPathItem::setZValue(-1.0);
 
@@ -177,31 +180,95 @@ void qpwgraph_connect::updatePathTo ( const QPointF& pos )
 	path.cubicTo(pos2, pos3, pos3_4);
 	path.lineTo(pos4);
 
-	const qreal arrow_angle = path.angleAtPercent(0.5) * M_PI / 180.0;
-	const QPointF arrow_pos0 = path.pointAtPercent(0.5);
+	m_polyline.clear();
+	m_polyline.append(pos1);
+	m_polyline.append(pos1_2);
+	m_polyline.append(pos3_4);
+	m_polyline.append(pos4);
+
+	// Arrow head at the curve mid-point, along the tangent there:
+	// evaluated analytically for the cubic Bezier at t = 0.5, as
+	// B(0.5) = (P0 + 3 P1 + 3 P2 + P3) / 8, and
+	// B'(0.5) ~ (P3 + P2 - P1 - P0) (scaled).
+	const QPointF arrow_pos0 = 0.125 * (pos1_2 + 3.0 * (pos2 + pos3) + pos3_4);
+	QPointF arrow_dir = pos3_4 + pos3 - pos2 - pos1_2;
+	qreal arrow_len = ::hypot(arrow_dir.x(), arrow_dir.y());
+	if (arrow_len < 1e-6) {
+		arrow_dir = pos3_4 - pos1_2;
+		arrow_len = ::hypot(arrow_dir.x(), arrow_dir.y());
+	}
+	if (arrow_len < 1e-6) {
+		arrow_dir = QPointF(1.0, 0.0);
+		arrow_len = 1.0;
+	}
+	const qreal ux = arrow_dir.x() / arrow_len;
+	const qreal uy = arrow_dir.y() / arrow_len;
 	const qreal arrow_size = 8.0;
+	static const qreal arrow_cos = ::cos(M_PI / 2.25) * arrow_size;
+	static const qreal arrow_sin = ::sin(M_PI / 2.25) * arrow_size;
 	QVector<QPointF> arrow;
 	arrow.append(arrow_pos0);
 	arrow.append(arrow_pos0 - QPointF(
-		::sin(arrow_angle + M_PI / 2.25) * arrow_size,
-		::cos(arrow_angle + M_PI / 2.25) * arrow_size));
+		ux * arrow_sin - uy * arrow_cos,
+		ux * arrow_cos + uy * arrow_sin));
 	arrow.append(arrow_pos0 - QPointF(
-		::sin(arrow_angle + M_PI - M_PI / 2.25) * arrow_size,
-		::cos(arrow_angle + M_PI - M_PI / 2.25) * arrow_size));
+		ux * arrow_sin + uy * arrow_cos,
+		uy * arrow_sin - ux * arrow_cos));
 	arrow.append(arrow_pos0);
 	path.addPolygon(QPolygonF(arrow));
 
 	/*QGraphicsPathItem::*/setPath(path);
+
+	m_shape_dirty = true;
 }
 
 
 void qpwgraph_connect::updatePath (void)
 {
-	if (m_port2) 
+	g_dirty_paths.remove(&m_dirty_item);
+
+	if (m_port2)
 		updatePathTo(m_port2->portPos());
 }
 
 
+// Deferred path updates (coalesced, once per event-loop cycle).
+void qpwgraph_connect::invalidatePath (void)
+{
+	if (isPathDirty())
+		return;
+
+	QGraphicsScene *scene = QGraphicsPathItem::scene();
+	if (scene == nullptr) {
+		updatePath();
+		return;
+	}
+
+	if (g_dirty_paths.isEmpty())
+		QTimer::singleShot(0, scene, &qpwgraph_connect::updateDirtyPaths);
+
+	g_dirty_paths.append(&m_dirty_item);
+}
+
+
+bool qpwgraph_connect::isPathDirty (void) const
+{
+	return (m_dirty_item.list() != nullptr);
+}
+
+
+void qpwgraph_connect::updateDirtyPaths (void)
+{
+	while (!g_dirty_paths.isEmpty())
+		g_dirty_paths.first()->object()->updatePath();
+}
+
+
+// Pending path updates (dirty connectors).
+//
+qpwgraph_list<qpwgraph_connect> qpwgraph_connect::g_dirty_paths;
+
+
 void qpwgraph_connect::paint ( QPainter *painter,
 	const QStyleOptionGraphicsItem *option, QWidget */*widget*/ )
 {
@@ -215,6 +282,16 @@ void qpwgraph_connect::paint ( QPainter *painter,
 		color = qpwgraph_item::foreground();
 	color.setAlpha(m_dimmed ? 128 : 255);
 
+	const qreal lod = option->levelOfDetailFromTransform(
+		painter->worldTransform());
+	if (lod < g_simplify_zoom) {
+		// Simplified (straight, no shadow) drawing...
+		painter->setBrush(Qt::NoBrush);
+		painter->setPen(QPen(color, 2));
+		painter->drawPolyline(m_polyline);
+		return;
+	}
+
 	const QPalette pal;
 	const bool is_darkest = (pal.base().color().value() < 24);
 	QColor shadow_color = (is_darkest ? Qt::white : Qt::black);
@@ -248,13 +325,74 @@ QVariant qpwgraph_connect::itemChange (
 
 QPainterPath qpwgraph_connect::shape (void) const
 {
+	if (m_shape_dirty)
+		updateShape();
+
+	return m_shape;
+}
+
+
+// Hit-test tolerance (beyond the stroke half-width).
+#define CONNECT_HIT_MARGIN 2.0
+
+bool qpwgraph_connect::contains ( const QPointF& point ) const
+{
+	// Coarse pre-test: bounding rectangle...
+	if (!QGraphicsPathItem::boundingRect().contains(point))
+		return false;
+
+	if (m_shape_dirty)
+		updateShape();
+
+	// Fine pre-test: distance to the flattened path segments...
+	const qreal d_max = 1.0 + CONNECT_HIT_MARGIN;
+	const qreal d2_max = d_max * d_max;
+	bool is_near = false;
+	foreach (const QPolygonF& poly, m_shape_polys) {
+		const int n = poly.count();
+		for (int i = 1; i < n && !is_near; ++i) {
+			const QPointF& p1 = poly.at(i - 1);
+			const QPointF& p2 = poly.at(i);
+			const QPointF d12 = p2 - p1;
+			const QPointF d1p = point - p1;
+			const qreal l2 = QPointF::dotProduct(d12, d12);
+			qreal t = (l2 > 0.0 ? QPointF::dotProduct(d1p, d12) / l2 : 0.0);
+			if (t < 0.0)
+				t = 0.0;
+			else
+			if (t > 1.0)
+				t = 1.0;
+			const QPointF dp = d1p - t * d12;
+			is_near = (QPointF::dotProduct(dp, dp) < d2_max);
+		}
+		if (is_near)
+			break;
+	}
+
+	if (!is_near)
+		return false;
+
+	// Exact test: the stroked path shape...
+	return m_shape.contains(point);
+}
+
+
+// Hit-test shape/polygons (lazy) cache updater.
+void qpwgraph_connect::updateShape (void) const
+{
+	const QPainterPath& path
+		= QGraphicsPathItem::path();
+
 #if (QT_VERSION < QT_VERSION_CHECK(6, 1, 0)) && (__cplusplus < 201703L)
-	return QGraphicsPathItem::shape();
+	m_shape = QGraphicsPathItem::shape();
 #else
 	const QPainterPathStroker stroker
 		= QPainterPathStroker(QPen(QColor(), 2));
-	return stroker.createStroke(path());
+	m_shape = stroker.createStroke(path);
 #endif
+	m_shape_polys = path.toSubpathPolygons();
+
+	m_shape_dirty = false;
 }
 
 
@@ -334,4 +472,19 @@ bool qpwgraph_connect::isConnectThroughNodes (void)
 }
 
 
+// Level-of-detail zoom threshold (straight lines below).
+//
+qreal qpwgraph_connect::g_simplify_zoom = 0.3;
+
+void qpwgraph_connect::setSimplifyZoom ( qreal zoom )
+{
+	g_simplify_zoom = zoom;
+}
+
+qreal qpwgraph_connect::simplifyZoom (void)
+{
+	return g_simplify_zoom;
+}
+
+
 // end of qpwgraph_connect.cpp
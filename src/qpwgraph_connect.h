@@ -24,6 +24,8 @@
 
 #include "qpwgraph_item.h"
 
+#include "qpwgraph_list.h"
+
 
 // Forward decls.
 class qpwgraph_port;
@@ -61,6 +63,12 @@ public:
 	void updatePathTo(const QPointF& pos);
 	void updatePath();
 
+	// Deferred path updates (coalesced, once per event-loop cycle).
+	void invalidatePath();
+	bool isPathDirty() const;
+
+	static void updateDirtyPaths();
+
 	// Selection propagation method...
 	void setSelectedEx(qpwgraph_port *port, bool is_selected);
 
@@ -78,6 +86,10 @@ public:
 	static void setConnectThroughNodes(bool on);
 	static bool isConnectThroughNodes();
 
+	// Level-of-detail zoom threshold (straight lines below).
+	static void setSimplifyZoom(qreal zoom);
+	static qreal simplifyZoom();
+
 protected:
 
 	void paint(QPainter *painter,
@@ -87,6 +99,11 @@ protected:
 
 	QPainterPath shape() const;
 
+	bool contains(const QPointF& point) const;
+
+	// Hit-test shape/polygons (lazy) cache updater.
+	void updateShape() const;
+
 private:
 
 	// Instance variables.
@@ -95,8 +112,25 @@ private:
 
 	bool m_dimmed;
 
+	// Simplified (straight) connector line.
+	QPolygonF m_polyline;
+
+	// Hit-test shape/polygons cache.
+	mutable QPainterPath    m_shape;
+	mutable QList<QPolygonF> m_shape_polys;
+	mutable bool            m_shape_dirty;
+
+	// Pending path update list item.
+	qpwgraph_list<qpwgraph_connect>::Item m_dirty_item;
+
+	// Pending path updates (dirty connectors).
+	static qpwgraph_list<qpwgraph_connect> g_dirty_paths;
+
 	// Connector curve draw style (through vs. around nodes)
 	static bool g_connect_through_nodes;
+
+	// Level-of-detail zoom threshold (straight lines below).
+	static qreal g_simplify_zoom;
 };
 
 
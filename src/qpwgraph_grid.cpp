@@ -0,0 +1,153 @@
+// qpwgraph_grid.cpp
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qpwgraph_grid.h"
+
+#include "qpwgraph_node.h"
+
+#include <QSet>
+
+#include <cmath>
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_grid -- Uniform grid spatial index (of node scene rectangles).
+
+// Constructor.
+qpwgraph_grid::qpwgraph_grid ( qreal cell_size )
+	: m_cell_size(cell_size > 1.0 ? cell_size : 1.0)
+{
+}
+
+
+// Accessors.
+qreal qpwgraph_grid::cellSize (void) const
+{
+	return m_cell_size;
+}
+
+
+int qpwgraph_grid::count (void) const
+{
+	return m_nodes.count();
+}
+
+
+// Index methods.
+void qpwgraph_grid::insert ( qpwgraph_node *node )
+{
+	if (m_nodes.contains(node))
+		remove(node);
+
+	const QRect& cells = qpwgraph_grid::cells(node->sceneBoundingRect());
+
+	for (int y = cells.top(); y <= cells.bottom(); ++y) {
+		for (int x = cells.left(); x <= cells.right(); ++x)
+			m_cells[cellKey(x, y)].append(node);
+	}
+
+	m_nodes.insert(node, cells);
+}
+
+
+void qpwgraph_grid::remove ( qpwgraph_node *node )
+{
+	QHash<qpwgraph_node *, QRect>::Iterator iter = m_nodes.find(node);
+	if (iter == m_nodes.end())
+		return;
+
+	const QRect cells = iter.value();
+	m_nodes.erase(iter);
+
+	for (int y = cells.top(); y <= cells.bottom(); ++y) {
+		for (int x = cells.left(); x <= cells.right(); ++x) {
+			QHash<quint64, QList<qpwgraph_node *> >::Iterator iter2
+				= m_cells.find(cellKey(x, y));
+			if (iter2 == m_cells.end())
+				continue;
+			iter2.value().removeOne(node);
+			if (iter2.value().isEmpty())
+				m_cells.erase(iter2);
+		}
+	}
+}
+
+
+void qpwgraph_grid::update ( qpwgraph_node *node )
+{
+	// Only when it has actually changed cells...
+	QHash<qpwgraph_node *, QRect>::ConstIterator iter = m_nodes.constFind(node);
+	if (iter != m_nodes.constEnd()
+		&& iter.value() == cells(node->sceneBoundingRect()))
+		return;
+
+	remove(node);
+	insert(node);
+}
+
+
+void qpwgraph_grid::clear (void)
+{
+	m_cells.clear();
+	m_nodes.clear();
+}
+
+
+// Candidate nodes that might intersect the given rectangle.
+QList<qpwgraph_node *> qpwgraph_grid::nodes ( const QRectF& rect ) const
+{
+	QList<qpwgraph_node *> nodes;
+	QSet<qpwgraph_node *> visited;
+
+	const QRect& cells = qpwgraph_grid::cells(rect);
+
+	for (int y = cells.top(); y <= cells.bottom(); ++y) {
+		for (int x = cells.left(); x <= cells.right(); ++x) {
+			QHash<quint64, QList<qpwgraph_node *> >::ConstIterator iter
+				= m_cells.constFind(cellKey(x, y));
+			if (iter == m_cells.constEnd())
+				continue;
+			foreach (qpwgraph_node *node, iter.value()) {
+				if (!visited.contains(node)) {
+					visited.insert(node);
+					nodes.append(node);
+				}
+			}
+		}
+	}
+
+	return nodes;
+}
+
+
+// Cell-range of a scene rectangle.
+QRect qpwgraph_grid::cells ( const QRectF& rect ) const
+{
+	const int x1 = int(std::floor(rect.left()   / m_cell_size));
+	const int y1 = int(std::floor(rect.top()    / m_cell_size));
+	const int x2 = int(std::floor(rect.right()  / m_cell_size));
+	const int y2 = int(std::floor(rect.bottom() / m_cell_size));
+
+	return QRect(QPoint(x1, y1), QPoint(x2, y2));
+}
+
+
+// end of qpwgraph_grid.cpp
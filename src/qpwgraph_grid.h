@@ -0,0 +1,86 @@
+// qpwgraph_grid.h
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qpwgraph_grid_h
+#define __qpwgraph_grid_h
+
+#include <QHash>
+#include <QList>
+#include <QRect>
+#include <QRectF>
+
+
+// Forward decls.
+class qpwgraph_node;
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_grid -- Uniform grid spatial index (of node scene rectangles).
+//
+// Each node is filed under every (square) cell its scene bounding
+// rectangle overlaps; looking up a rectangle only visits the cells it
+// overlaps, yielding candidate nodes for an exact intersection test.
+//
+
+class qpwgraph_grid
+{
+public:
+
+	// Constructor.
+	qpwgraph_grid(qreal cell_size = 256.0);
+
+	// Accessors.
+	qreal cellSize() const;
+
+	int count() const;
+
+	// Index methods.
+	void insert(qpwgraph_node *node);
+	void remove(qpwgraph_node *node);
+	void update(qpwgraph_node *node);
+
+	void clear();
+
+	// Candidate nodes that might intersect the given rectangle.
+	QList<qpwgraph_node *> nodes(const QRectF& rect) const;
+
+protected:
+
+	// Cell-range of a scene rectangle.
+	QRect cells(const QRectF& rect) const;
+
+	// Cell hash key.
+	static quint64 cellKey(int x, int y)
+		{ return (quint64(quint32(x)) << 32) | quint32(y); }
+
+private:
+
+	// Instance variables.
+	qreal m_cell_size;
+
+	QHash<quint64, QList<qpwgraph_node *> > m_cells;
+	QHash<qpwgraph_node *, QRect> m_nodes;
+};
+
+
+#endif	// __qpwgraph_grid_h
+
+// end of qpwgraph_grid.h
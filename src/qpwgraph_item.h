@@ -22,6 +22,8 @@
 #ifndef __qpwgraph_item_h
 #define __qpwgraph_item_h
 
+#include "qpwgraph_atom.h"
+
 #include <QGraphicsPathItem>
 
 #include <QColor>
@@ -104,13 +106,15 @@ public:
 	public:
 
 		// Constructors.
-		NameKey (const QString& name, Mode mode, uint type = 0)
+		NameKey (const qpwgraph_atom& name, Mode mode, uint type = 0)
 			: m_name(name), m_mode(mode), m_type(type) {}
 		NameKey (const NameKey& key)
-			: m_name(key.name()), m_mode(key.mode()), m_type(key.type()) {}
+			: m_name(key.atom()), m_mode(key.mode()), m_type(key.type()) {}
 
 		// Key accessors.
 		const QString& name() const
+			{ return m_name.name(); }
+		const qpwgraph_atom& atom() const
 			{ return m_name; }
 		Mode mode() const
 			{ return m_mode; }
@@ -122,13 +126,13 @@ public:
 		{
 			return NameKey::type() == key.type()
 				&& NameKey::mode() == key.mode()
-				&& NameKey::name() == key.name();
+				&& NameKey::atom() == key.atom();
 		}
 
 	private:
 
 		// Key fields.
-		QString m_name;
+		qpwgraph_atom m_name;
 		Mode m_mode;
 		uint m_type;
 	};
@@ -168,7 +172,7 @@ inline uint qHash ( const qpwgraph_item::IdKey& key )
 
 inline uint qHash ( const qpwgraph_item::NameKey& key )
 {
-	return qHash(key.name()) ^ qHash(uint(key.mode())) ^ qHash(key.type());
+	return qHash(key.atom()) ^ qHash(uint(key.mode())) ^ qHash(key.type());
 }
 
 
@@ -0,0 +1,556 @@
+// qpwgraph_layout.cpp
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qpwgraph_layout.h"
+
+#include "qpwgraph_toposort.h"
+
+#include "qpwgraph_node.h"
+#include "qpwgraph_port.h"
+#include "qpwgraph_connect.h"
+
+#include <QHash>
+
+#include <algorithm>
+#include <limits>
+
+
+// Layered layout parameters.
+#define LAYOUT_MIN_XPAD      40.0
+#define LAYOUT_YPAD          20.0
+#define LAYOUT_DUMMY_YPAD    10.0
+#define LAYOUT_MAX_SWEEPS    24
+#define LAYOUT_MAX_STALLS    4
+#define LAYOUT_MAX_ALIGNS    4
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_layout -- Graph layout engine (abstract interface).
+
+// Graph snapshot (GUI thread only).
+qpwgraph_layout::Graph qpwgraph_layout::snapshot (
+	const QList<qpwgraph_node *>& nodes, const QRectF& viewport )
+{
+	Graph graph;
+	graph.viewport = viewport;
+
+	const int count = nodes.count();
+	graph.nodes.reserve(count);
+
+	QHash<qpwgraph_node *, int> indexes;
+	indexes.reserve(count);
+	for (int i = 0; i < count; ++i)
+		indexes.insert(nodes.at(i), i);
+
+	for (int i = 0; i < count; ++i) {
+		qpwgraph_node *node = nodes.at(i);
+		Node n;
+		n.size = node->boundingRect().size();
+		n.pos  = node->pos();
+		n.name = node->nodeName();
+		const QList<qpwgraph_port *>& ports = node->ports();
+		n.port_type = (ports.isEmpty() ? 0 : ports.first()->portType());
+		n.ports   = ports.count();
+		n.inputs  = 0;
+		n.outputs = 0;
+		n.input_connects = 0;
+		foreach (qpwgraph_port *port, ports) {
+			if (port->isInput())
+				++n.inputs;
+			else
+			if (port->isOutput())
+				++n.outputs;
+			foreach (qpwgraph_connect *connect, port->connects()) {
+				qpwgraph_port *port2 = connect->port1();
+				if (port2 == port)
+					port2 = connect->port2();
+				if (port2 == nullptr)
+					continue;
+				qpwgraph_node *node2 = port2->portNode();
+				if (node2 == node)
+					continue;
+				if (port->isInput()) {
+					++n.input_connects;
+					continue;
+				}
+				const int j = indexes.value(node2, -1);
+				if (j < 0)
+					continue;
+				Edge e;
+				e.node1 = i;
+				e.node2 = j;
+				e.y1 = port->pos().y() + 0.5 * port->boundingRect().height();
+				e.y2 = port2->pos().y() + 0.5 * port2->boundingRect().height();
+				graph.edges.append(e);
+			}
+		}
+		graph.nodes.append(n);
+	}
+
+	return graph;
+}
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_layout_sugiyama -- Layered graph layout engine.
+
+// Engine method.
+qpwgraph_layout::Positions qpwgraph_layout_sugiyama::arrange (
+	const Graph& graph )
+{
+	const int count = graph.nodes.size();
+	if (count < 1)
+		return Positions();
+
+	setProgress(0);
+
+	// 1. Layering...
+	qpwgraph_toposort topo(graph);
+	const QVector<int> ranks = topo.rank();
+
+	// 2. Long edges split into dummy vertices...
+	buildLayers(graph, ranks, topo.sortedNodes());
+
+	setProgress(10);
+
+	// 3. Crossing reduction...
+	reduceCrossings();
+
+	setProgress(80);
+
+	// 4. Coordinate assignment.
+	Positions positions;
+	if (!isCanceled())
+		positions = assignCoords(graph);
+	if (isCanceled())
+		positions.clear();
+
+	setProgress(100);
+
+	m_vertices.clear();
+	m_segments.clear();
+	m_layers.clear();
+	m_positions.clear();
+
+	return positions;
+}
+
+
+// Layered graph builder.
+void qpwgraph_layout_sugiyama::buildLayers ( const Graph& graph,
+	const QVector<int>& ranks, const QVector<int>& order )
+{
+	const int count = graph.nodes.size();
+
+	int max_rank = 0;
+	foreach (int rank, ranks)
+		max_rank = qMax(max_rank, rank);
+
+	m_vertices.clear();
+	m_segments.clear();
+	m_layers.clear();
+	m_layers.resize(max_rank + 1);
+
+	// Real nodes first (vertex index == node index)...
+	m_vertices.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		Vertex v;
+		v.node = i;
+		v.layer = ranks.at(i);
+		v.height = graph.nodes.at(i).size.height();
+		m_vertices.append(v);
+	}
+
+	// Initial in-layer order, as sorted by rank...
+	foreach (int i, order)
+		m_layers[ranks.at(i)].append(i);
+
+	// Segments, splitting long edges into dummy vertices;
+	// feedback (or flat) edges are just left out...
+	foreach (const Edge& e, graph.edges) {
+		const int layer1 = ranks.at(e.node1);
+		const int layer2 = ranks.at(e.node2);
+		if (layer1 >= layer2)
+			continue;
+		int upper = e.node1;
+		qreal y1 = e.y1;
+		for (int layer = layer1 + 1; layer < layer2; ++layer) {
+			const int dummy = m_vertices.size();
+			Vertex v;
+			v.node = -1;
+			v.layer = layer;
+			v.height = 0.0;
+			m_vertices.append(v);
+			m_layers[layer].append(dummy);
+			Segment s;
+			s.upper = upper;
+			s.lower = dummy;
+			s.y1 = y1;
+			s.y2 = 0.0;
+			m_vertices[upper].downs.append(m_segments.size());
+			m_vertices[dummy].ups.append(m_segments.size());
+			m_segments.append(s);
+			upper = dummy;
+			y1 = 0.0;
+		}
+		Segment s;
+		s.upper = upper;
+		s.lower = e.node2;
+		s.y1 = y1;
+		s.y2 = e.y2;
+		m_vertices[upper].downs.append(m_segments.size());
+		m_vertices[e.node2].ups.append(m_segments.size());
+		m_segments.append(s);
+	}
+
+	// In-layer positions...
+	m_positions.resize(m_vertices.size());
+	foreach (const QVector<int>& layer, m_layers) {
+		const int n = layer.size();
+		for (int k = 0; k < n; ++k)
+			m_positions[layer.at(k)] = k;
+	}
+}
+
+
+// Iterated barycenter crossing reduction (keeps the best found).
+void qpwgraph_layout_sugiyama::reduceCrossings (void)
+{
+	const int nlayers = m_layers.size();
+	if (nlayers < 2)
+		return;
+
+	int best = countCrossings();
+	QVector<QVector<int> > best_layers = m_layers;
+
+	int stalls = 0;
+	for (int sweep = 0; sweep < LAYOUT_MAX_SWEEPS && best > 0; ++sweep) {
+		if (isCanceled())
+			return;
+		setProgress(10 + (70 * sweep) / LAYOUT_MAX_SWEEPS);
+		for (int layer = 1; layer < nlayers; ++layer)
+			sweepLayer(layer, true);
+		for (int layer = nlayers - 2; layer >= 0; --layer)
+			sweepLayer(layer, false);
+		const int crossings = countCrossings();
+		if (crossings < best) {
+			best = crossings;
+			best_layers = m_layers;
+			stalls = 0;
+		}
+		else
+		if (++stalls >= LAYOUT_MAX_STALLS)
+			break;
+	}
+
+	m_layers = best_layers;
+
+	foreach (const QVector<int>& layer, m_layers) {
+		const int n = layer.size();
+		for (int k = 0; k < n; ++k)
+			m_positions[layer.at(k)] = k;
+	}
+}
+
+
+// Barycenter sweep (downward or upward); layer orders only.
+void qpwgraph_layout_sugiyama::sweepLayer ( int layer, bool down )
+{
+	QVector<int>& vertices = m_layers[layer];
+	const int n = vertices.size();
+	if (n < 2)
+		return;
+
+	// Vertices with no neighbors on that side keep their current place...
+	QVector<QPair<qreal, int> > keys;
+	keys.reserve(n);
+	foreach (int v, vertices) {
+		const QVector<int>& segments
+			= (down ? m_vertices.at(v).ups : m_vertices.at(v).downs);
+		if (segments.isEmpty()) {
+			keys.append(qMakePair(qreal(m_positions.at(v)), v));
+			continue;
+		}
+		qreal sum = 0.0;
+		foreach (int s, segments) {
+			const Segment& segment = m_segments.at(s);
+			sum += m_positions.at(down ? segment.upper : segment.lower);
+		}
+		keys.append(qMakePair(sum / qreal(segments.size()), v));
+	}
+
+	std::stable_sort(keys.begin(), keys.end(),
+		[](const QPair<qreal, int>& key1, const QPair<qreal, int>& key2)
+			{ return key1.first < key2.first; });
+
+	for (int k = 0; k < n; ++k)
+		vertices[k] = keys.at(k).second;
+
+	for (int k = 0; k < n; ++k)
+		m_positions[vertices.at(k)] = k;
+}
+
+
+// Crossings between the given layer and the next one below
+// (inversion count, with a binary indexed tree).
+int qpwgraph_layout_sugiyama::countCrossings ( int layer ) const
+{
+	QVector<QPair<int, int> > pairs;
+	foreach (int v, m_layers.at(layer)) {
+		foreach (int s, m_vertices.at(v).downs) {
+			const Segment& segment = m_segments.at(s);
+			pairs.append(qMakePair(
+				m_positions.at(segment.upper),
+				m_positions.at(segment.lower)));
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+
+	const int n = m_layers.at(layer + 1).size();
+	QVector<int> tree(n + 1, 0);
+
+	int crossings = 0;
+	int total = 0;
+	for (const QPair<int, int>& pair : pairs) {
+		// How many so far went strictly further down right?...
+		int below = 0;
+		for (int i = pair.second + 1; i > 0; i -= (i & -i))
+			below += tree.at(i);
+		crossings += total - below;
+		for (int i = pair.second + 1; i <= n; i += (i & -i))
+			++tree[i];
+		++total;
+	}
+
+	return crossings;
+}
+
+
+int qpwgraph_layout_sugiyama::countCrossings (void) const
+{
+	int crossings = 0;
+
+	const int nlayers = m_layers.size();
+	for (int layer = 0; layer < nlayers - 1; ++layer)
+		crossings += countCrossings(layer);
+
+	return crossings;
+}
+
+
+// Coordinate assignment.
+qpwgraph_layout::Positions qpwgraph_layout_sugiyama::assignCoords (
+	const Graph& graph )
+{
+	const int count = graph.nodes.size();
+	const int nlayers = m_layers.size();
+
+	qreal xmin = std::numeric_limits<qreal>::infinity();
+	qreal ymin = std::numeric_limits<qreal>::infinity();
+	foreach (const Node& n, graph.nodes) {
+		xmin = qMin(xmin, n.pos.x());
+		ymin = qMin(ymin, n.pos.y());
+	}
+
+	// Columns, one for each (non-empty) layer...
+	QVector<qreal> widths(nlayers, 0.0);
+	for (int i = 0; i < count; ++i) {
+		const int layer = m_vertices.at(i).layer;
+		widths[layer] = qMax(widths.at(layer), graph.nodes.at(i).size.width());
+	}
+
+	int ncolumns = 0;
+	qreal total_width = LAYOUT_MIN_XPAD;
+	for (int layer = 0; layer < nlayers; ++layer) {
+		if (m_layers.at(layer).isEmpty())
+			continue;
+		total_width += widths.at(layer);
+		++ncolumns;
+	}
+
+	// Expand to fill viewport width...
+	const qreal xpad = qMax(LAYOUT_MIN_XPAD,
+		(graph.viewport.width() - total_width) / qMax(2, ncolumns - 1));
+
+	QVector<qreal> xs(nlayers, xmin);
+	qreal x = xmin;
+	for (int layer = 0; layer < nlayers; ++layer) {
+		if (m_layers.at(layer).isEmpty())
+			continue;
+		xs[layer] = x;
+		x += widths.at(layer) + xpad;
+	}
+
+	// Rows, initially just stacked in order...
+	QVector<qreal> ys(m_vertices.size(), 0.0);
+	foreach (const QVector<int>& layer, m_layers) {
+		qreal y = 0.0;
+		int prev = -1;
+		foreach (int v, layer) {
+			if (prev >= 0) {
+				const bool dummy
+					= (m_vertices.at(prev).node < 0 || m_vertices.at(v).node < 0);
+				y += m_vertices.at(prev).height
+					+ (dummy ? LAYOUT_DUMMY_YPAD : LAYOUT_YPAD);
+			}
+			ys[v] = y;
+			prev = v;
+		}
+	}
+
+	// Then aligned to their neighbors, back and forth...
+	for (int align = 0; align < LAYOUT_MAX_ALIGNS; ++align) {
+		if (isCanceled())
+			return Positions();
+		for (int layer = 1; layer < nlayers; ++layer)
+			alignLayer(layer, true, ys);
+		for (int layer = nlayers - 2; layer >= 0; --layer)
+			alignLayer(layer, false, ys);
+	}
+	for (int layer = 1; layer < nlayers; ++layer)
+		alignLayer(layer, true, ys);
+
+	// Final positions, top-left anchored as before...
+	qreal ytop = std::numeric_limits<qreal>::infinity();
+	for (int i = 0; i < count; ++i)
+		ytop = qMin(ytop, ys.at(i));
+
+	Positions positions(count);
+	for (int i = 0; i < count; ++i) {
+		const int layer = m_vertices.at(i).layer;
+		const qreal w = graph.nodes.at(i).size.width();
+		qreal dx = 0.0;
+		if (layer == 0) {
+			// Right-align sources
+			dx = widths.at(layer) - w;
+		}
+		else
+		if (layer < nlayers - 1) {
+			// Center-align everything else
+			dx = 0.5 * (widths.at(layer) - w);
+		}
+		// Left-align sinks (last layer)
+		positions[i] = QPointF(xs.at(layer) + dx, ymin + ys.at(i) - ytop);
+	}
+
+	return positions;
+}
+
+
+// Vertical coordinates sweep (downward or upward): each vertex wants its
+// ports level with the mean of its neighbors ports; order is preserved
+// and overlaps get pushed down, then the whole layer shifted back up.
+void qpwgraph_layout_sugiyama::alignLayer (
+	int layer, bool down, QVector<qreal>& ys ) const
+{
+	const QVector<int>& vertices = m_layers.at(layer);
+	const int n = vertices.size();
+	if (n < 1)
+		return;
+
+	QVector<qreal> wanted(n);
+	QVector<bool> linked(n, false);
+	for (int k = 0; k < n; ++k) {
+		const int v = vertices.at(k);
+		const QVector<int>& segments
+			= (down ? m_vertices.at(v).ups : m_vertices.at(v).downs);
+		if (segments.isEmpty()) {
+			wanted[k] = ys.at(v);
+			continue;
+		}
+		qreal sum = 0.0;
+		foreach (int s, segments) {
+			const Segment& segment = m_segments.at(s);
+			if (down)
+				sum += ys.at(segment.upper) + segment.y1 - segment.y2;
+			else
+				sum += ys.at(segment.lower) + segment.y2 - segment.y1;
+		}
+		wanted[k] = sum / qreal(segments.size());
+		linked[k] = true;
+	}
+
+	QVector<qreal> placed(n);
+	placed[0] = wanted.at(0);
+	for (int k = 1; k < n; ++k) {
+		const int prev = vertices.at(k - 1);
+		const bool dummy
+			= (m_vertices.at(prev).node < 0 || m_vertices.at(vertices.at(k)).node < 0);
+		const qreal ymin = placed.at(k - 1) + m_vertices.at(prev).height
+			+ (dummy ? LAYOUT_DUMMY_YPAD : LAYOUT_YPAD);
+		placed[k] = qMax(wanted.at(k), ymin);
+	}
+
+	qreal shift = 0.0;
+	int nlinked = 0;
+	for (int k = 0; k < n; ++k) {
+		if (linked.at(k)) {
+			shift += wanted.at(k) - placed.at(k);
+			++nlinked;
+		}
+	}
+	if (nlinked > 0)
+		shift /= qreal(nlinked);
+
+	for (int k = 0; k < n; ++k)
+		ys[vertices.at(k)] = placed.at(k) + shift;
+}
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_layout_thread -- Graph layout worker thread.
+
+// Constructor.
+qpwgraph_layout_thread::qpwgraph_layout_thread ( qpwgraph_layout *layout,
+	const qpwgraph_layout::Graph& graph, QObject *parent )
+	: QThread(parent), m_layout(layout), m_graph(graph)
+{
+	m_layout->setCanceled(false);
+}
+
+
+// Cancel and wait for the computation to end.
+void qpwgraph_layout_thread::cancel (void)
+{
+	m_layout->setCanceled(true);
+
+	QThread::wait();
+
+	m_positions.clear();
+}
+
+
+// Resulting positions (valid only when finished, empty if canceled).
+const qpwgraph_layout::Positions& qpwgraph_layout_thread::positions (void) const
+{
+	return m_positions;
+}
+
+
+// Worker method.
+void qpwgraph_layout_thread::run (void)
+{
+	m_positions = m_layout->arrange(m_graph);
+}
+
+
+// end of qpwgraph_layout.cpp
@@ -0,0 +1,225 @@
+// qpwgraph_layout.h
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qpwgraph_layout_h
+#define __qpwgraph_layout_h
+
+#include <QString>
+#include <QVector>
+#include <QList>
+#include <QPointF>
+#include <QSizeF>
+#include <QRectF>
+
+#include <QThread>
+#include <QAtomicInt>
+
+
+// Forward decls.
+class qpwgraph_node;
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_layout -- Graph layout engine (abstract interface).
+//
+// Engines work on an immutable snapshot of the graph only (node sizes,
+// positions and port offsets, plus the connections among them), never
+// on the live canvas items, so that they may run off the GUI thread.
+//
+
+class qpwgraph_layout
+{
+public:
+
+	// Graph snapshot node.
+	struct Node
+	{
+		QSizeF  size;
+		QPointF pos;
+		QString name;
+
+		uint port_type;			// First port type (0=none).
+		int  ports;
+		int  inputs;
+		int  outputs;
+		int  input_connects;	// External (incl. non-snapshot nodes).
+	};
+
+	// Graph snapshot edge (from an output to an input port).
+	struct Edge
+	{
+		int   node1;
+		int   node2;
+		qreal y1;				// Port offsets, relative to each
+		qreal y2;				// node top (vertical center).
+	};
+
+	// Graph snapshot.
+	struct Graph
+	{
+		QVector<Node> nodes;
+		QVector<Edge> edges;
+		QRectF viewport;
+	};
+
+	// New node positions (same index order as snapshot nodes).
+	typedef QVector<QPointF> Positions;
+
+	// Constructor.
+	qpwgraph_layout() : m_canceled(0), m_progress(0) {}
+
+	// Destructor.
+	virtual ~qpwgraph_layout() {}
+
+	// Engine method (snapshot-only; reentrant).
+	// Returns no positions at all when canceled.
+	virtual Positions arrange(const Graph& graph) = 0;
+
+	// Cancellation (thread-safe).
+	void setCanceled(bool canceled)
+		{ m_canceled.storeRelease(canceled ? 1 : 0); }
+	bool isCanceled() const
+		{ return (m_canceled.loadAcquire() != 0); }
+
+	// Progress percentage (thread-safe).
+	int progress() const
+		{ return m_progress.loadAcquire(); }
+
+	// Graph snapshot (GUI thread only).
+	static Graph snapshot(
+		const QList<qpwgraph_node *>& nodes, const QRectF& viewport);
+
+protected:
+
+	void setProgress(int progress)
+		{ m_progress.storeRelease(progress); }
+
+private:
+
+	// Instance variables.
+	QAtomicInt m_canceled;
+	QAtomicInt m_progress;
+};
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_layout_sugiyama -- Layered graph layout engine.
+//
+// The classic Sugiyama pipeline: topological layering (as by
+// qpwgraph_toposort), long edges split into dummy vertices, iterated
+// barycenter crossing reduction and finally coordinate assignment,
+// in columns, one for each layer.
+//
+
+class qpwgraph_layout_sugiyama : public qpwgraph_layout
+{
+public:
+
+	// Engine method.
+	Positions arrange(const Graph& graph) override;
+
+protected:
+
+	// Layered graph vertex (real node or dummy).
+	struct Vertex
+	{
+		int   node;				// Snapshot node index (-1=dummy).
+		int   layer;
+		qreal height;
+		QVector<int> ups;		// Segments to the layer above.
+		QVector<int> downs;		// Segments to the layer below.
+	};
+
+	// Layered graph segment (between adjacent layers).
+	struct Segment
+	{
+		int   upper;
+		int   lower;
+		qreal y1;				// Port offsets, relative to each
+		qreal y2;				// vertex top.
+	};
+
+	// Pipeline stages.
+	void buildLayers(const Graph& graph, const QVector<int>& ranks,
+		const QVector<int>& order);
+	void reduceCrossings();
+	Positions assignCoords(const Graph& graph);
+
+	// Barycenter sweep (downward or upward); layer orders only.
+	void sweepLayer(int layer, bool down);
+
+	// Crossing counters.
+	int countCrossings(int layer) const;
+	int countCrossings() const;
+
+	// Vertical coordinates sweep (downward or upward).
+	void alignLayer(int layer, bool down, QVector<qreal>& ys) const;
+
+private:
+
+	// Instance variables (per arrange call).
+	QVector<Vertex>  m_vertices;
+	QVector<Segment> m_segments;
+
+	QVector<QVector<int> > m_layers;
+	QVector<int> m_positions;
+};
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_layout_thread -- Graph layout worker thread.
+//
+// Runs a layout engine over its own copy of a graph snapshot; the engine
+// must not be used elsewhere until the thread is finished.
+//
+
+class qpwgraph_layout_thread : public QThread
+{
+public:
+
+	// Constructor.
+	qpwgraph_layout_thread(qpwgraph_layout *layout,
+		const qpwgraph_layout::Graph& graph, QObject *parent = nullptr);
+
+	// Cancel and wait for the computation to end.
+	void cancel();
+
+	// Resulting positions (valid only when finished, empty if canceled).
+	const qpwgraph_layout::Positions& positions() const;
+
+protected:
+
+	// Worker method.
+	void run() override;
+
+private:
+
+	// Instance variables.
+	qpwgraph_layout *m_layout;
+
+	qpwgraph_layout::Graph m_graph;
+	qpwgraph_layout::Positions m_positions;
+};
+
+
+#endif	// __qpwgraph_layout_h
+
+// end of qpwgraph_layout.h
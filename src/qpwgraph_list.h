@@ -0,0 +1,180 @@
+// qpwgraph_list.h
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qpwgraph_list_h
+#define __qpwgraph_list_h
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_list -- Generic intrusive doubly-linked list.
+//
+// Items are embedded in the listed objects themselves, one for each
+// list they might belong to; append and remove are both O(1) and an
+// item unlinks itself from its current list on destruction.
+//
+
+template <typename T>
+class qpwgraph_list
+{
+public:
+
+	// Intrusive list item.
+	class Item
+	{
+	public:
+
+		// Constructor.
+		Item(T *object) : m_object(object),
+			m_list(nullptr), m_prev(nullptr), m_next(nullptr) {}
+
+		// Destructor.
+		~Item() { unlink(); }
+
+		// Accessors.
+		T *object() const { return m_object; }
+
+		qpwgraph_list<T> *list() const { return m_list; }
+
+		Item *prev() const { return m_prev; }
+		Item *next() const { return m_next; }
+
+		// Self-removal from its current list, if any.
+		void unlink() { if (m_list) m_list->remove(this); }
+
+	private:
+
+		// Not copyable.
+		Item(const Item&) = delete;
+		Item& operator= (const Item&) = delete;
+
+		friend class qpwgraph_list<T>;
+
+		// Instance variables.
+		T *m_object;
+
+		qpwgraph_list<T> *m_list;
+
+		Item *m_prev;
+		Item *m_next;
+	};
+
+	// Forward iterator (range-based for loops).
+	class Iterator
+	{
+	public:
+
+		Iterator(Item *item) : m_item(item) {}
+
+		T *operator* () const
+			{ return m_item->object(); }
+		Iterator& operator++ ()
+			{ m_item = m_item->next(); return *this; }
+		bool operator!= (const Iterator& iter) const
+			{ return m_item != iter.m_item; }
+
+	private:
+
+		Item *m_item;
+	};
+
+	// Constructor.
+	qpwgraph_list() : m_first(nullptr), m_last(nullptr), m_count(0) {}
+
+	// Destructor.
+	~qpwgraph_list() { clear(); }
+
+	// Accessors.
+	Item *first() const { return m_first; }
+	Item *last()  const { return m_last;  }
+
+	int count() const { return m_count; }
+
+	bool isEmpty() const { return (m_first == nullptr); }
+
+	// List methods.
+	void append(Item *item)
+	{
+		item->unlink();
+
+		item->m_list = this;
+		item->m_prev = m_last;
+		item->m_next = nullptr;
+
+		if (m_last)
+			m_last->m_next = item;
+		else
+			m_first = item;
+
+		m_last = item;
+
+		++m_count;
+	}
+
+	void remove(Item *item)
+	{
+		if (item->m_list != this)
+			return;
+
+		if (item->m_prev)
+			item->m_prev->m_next = item->m_next;
+		else
+			m_first = item->m_next;
+
+		if (item->m_next)
+			item->m_next->m_prev = item->m_prev;
+		else
+			m_last = item->m_prev;
+
+		item->m_list = nullptr;
+		item->m_prev = nullptr;
+		item->m_next = nullptr;
+
+		--m_count;
+	}
+
+	// Unlink all items (objects are not deleted).
+	void clear()
+	{
+		while (m_first)
+			remove(m_first);
+	}
+
+	// Range-based for loops.
+	Iterator begin() const { return Iterator(m_first); }
+	Iterator end() const { return Iterator(nullptr); }
+
+private:
+
+	// Not copyable.
+	qpwgraph_list(const qpwgraph_list&) = delete;
+	qpwgraph_list& operator= (const qpwgraph_list&) = delete;
+
+	// Instance variables.
+	Item *m_first;
+	Item *m_last;
+
+	int m_count;
+};
+
+
+#endif	// __qpwgraph_list_h
+
+// end of qpwgraph_list.h
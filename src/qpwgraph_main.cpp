@@ -70,6 +70,14 @@
 #include <cmath>
 
 
+// Refresh cycle timings (msecs).
+#define DEFAULT_REFRESH_DELAY  30
+#define MIN_REFRESH_DELAY      10
+#define MAX_REFRESH_DELAY    1000
+#define MAX_REFRESH_LATENCY   250
+#define BUSY_REFRESH_DELAY   1200
+
+
 //----------------------------------------------------------------------------
 // qpwgraph_zoom_slider -- Custom slider widget.
 
@@ -139,6 +147,15 @@ qpwgraph_main::qpwgraph_main (
 	m_thumb = nullptr;
 	m_thumb_update = 0;
 
+	m_refresh_timer = new QTimer(this);
+	m_refresh_timer->setSingleShot(true);
+	m_refresh_delay = DEFAULT_REFRESH_DELAY;
+	m_refresh_busy = false;
+
+	QObject::connect(m_refresh_timer,
+		SIGNAL(timeout()),
+		SLOT(refresh()));
+
 	QUndoStack *commands = m_ui.graphCanvas->commands();
 
 	QAction *undo_action = commands->createUndoAction(this, tr("&Undo"));
@@ -223,6 +240,9 @@ qpwgraph_main::qpwgraph_main (
 		QObject::connect(m_pipewire,
 			SIGNAL(changed()),
 			SLOT(pipewire_changed()));
+		QObject::connect(m_pipewire,
+			SIGNAL(connectResult(uint, uint, bool, int)),
+			SLOT(pipewire_connectResult(uint, uint, bool, int)));
 	}
 
 	QObject::connect(m_ui.graphCanvas,
@@ -236,11 +256,11 @@ qpwgraph_main::qpwgraph_main (
 		SLOT(removed(qpwgraph_node *)));
 
 	QObject::connect(m_ui.graphCanvas,
-		SIGNAL(connected(qpwgraph_port *, qpwgraph_port *)),
-		SLOT(connected(qpwgraph_port *, qpwgraph_port *)));
+		SIGNAL(connected(const qpwgraph_port::Pairs&)),
+		SLOT(connected(const qpwgraph_port::Pairs&)));
 	QObject::connect(m_ui.graphCanvas,
-		SIGNAL(disconnected(qpwgraph_port *, qpwgraph_port *)),
-		SLOT(disconnected(qpwgraph_port *, qpwgraph_port *)));
+		SIGNAL(disconnected(const qpwgraph_port::Pairs&)),
+		SLOT(disconnected(const qpwgraph_port::Pairs&)));
 
 	QObject::connect(m_ui.graphCanvas,
 		SIGNAL(connected(qpwgraph_connect *)),
@@ -539,8 +559,6 @@ qpwgraph_main::qpwgraph_main (
 	// Trigger refresh cycle...
 	pipewire_changed();
 	alsamidi_changed();
-
-	QTimer::singleShot(300, this, SLOT(refresh()));
 }
 
 
@@ -663,6 +681,7 @@ void qpwgraph_main::updateOptions ( bool prompt )
 			m_alsamidi, SIGNAL(changed()),
 			this, SLOT(alsamidi_changed()));
 		++m_alsamidi_changed;
+		scheduleRefresh();
 	}
 	else
 	if (!alsamidi_enabled && m_alsamidi) {
@@ -675,6 +694,18 @@ void qpwgraph_main::updateOptions ( bool prompt )
 	}
 #endif
 
+	m_refresh_delay = qBound(
+		MIN_REFRESH_DELAY, m_config->refreshDelay(), MAX_REFRESH_DELAY);
+
+	m_ui.graphCanvas->setArrangeNodesAnimated(m_config->isArrangeNodesAnimated());
+
+	m_ui.graphCanvas->setSimplifyNodesZoom(
+		0.01 * qreal(m_config->simplifyNodesZoom()));
+	m_ui.graphCanvas->setSimplifyConnectsZoom(
+		0.01 * qreal(m_config->simplifyConnectsZoom()));
+
+	m_ui.graphCanvas->setNodeShadows(m_config->isNodeShadows());
+
 	m_ui.graphCanvas->setFilterNodesEnabled(m_config->isFilterNodesEnabled());
 	m_ui.graphCanvas->setFilterNodesList(m_config->filterNodesList());
 
@@ -809,17 +840,25 @@ void qpwgraph_main::patchbaySave (void)
 
 void qpwgraph_main::patchbaySaveAs (void)
 {
+	const QString& binary_ext
+		= qpwgraph_patchbay::binaryFileExt();
+	QString filter;
 	const QString& path
 		= QFileDialog::getSaveFileName(this,
 			tr("Save Patchbay File"),
 			patchbayFileDir(),
-			patchbayFileFilter());
+			patchbayFileFilter(), &filter);
 
 	if (path.isEmpty())
 		return;
 
-	if (QFileInfo(path).suffix().isEmpty())
-		patchbaySaveFile(path + '.' + patchbayFileExt());
+	if (QFileInfo(path).suffix().isEmpty()) {
+		if (filter.contains("*." + binary_ext)
+			&& !filter.contains("*." + patchbayFileExt() + ' '))
+			patchbaySaveFile(path + '.' + binary_ext);
+		else
+			patchbaySaveFile(path + '.' + patchbayFileExt());
+	}
 	else
 		patchbaySaveFile(path);
 
@@ -910,6 +949,7 @@ void qpwgraph_main::viewMenubar ( bool on )
 	m_ui.MenuBar->setVisible(on);
 
 	++m_thumb_update;
+	scheduleRefresh();
 }
 
 
@@ -918,6 +958,7 @@ void qpwgraph_main::viewGraphToolbar ( bool on )
 	m_ui.graphToolbar->setVisible(on);
 
 	++m_thumb_update;
+	scheduleRefresh();
 }
 
 
@@ -926,6 +967,7 @@ void qpwgraph_main::viewPatchbayToolbar ( bool on )
 	m_ui.patchbayToolbar->setVisible(on);
 
 	++m_thumb_update;
+	scheduleRefresh();
 }
 
 
@@ -934,6 +976,7 @@ void qpwgraph_main::viewStatusbar ( bool on )
 	m_ui.StatusBar->setVisible(on);
 
 	++m_thumb_update;
+	scheduleRefresh();
 }
 
 
@@ -970,6 +1013,7 @@ void qpwgraph_main::viewThumbview ( int thumbview )
 				SLOT(viewThumbview(int)),
 				Qt::QueuedConnection);
 			++m_thumb_update;
+			scheduleRefresh();
 		}
 	}
 
@@ -1005,6 +1049,7 @@ void qpwgraph_main::viewTextBesideIcons ( bool on )
 	}
 
 	++m_thumb_update;
+	scheduleRefresh();
 }
 
 
@@ -1107,7 +1152,10 @@ void qpwgraph_main::viewSortOrderAction (void)
 void qpwgraph_main::viewRepelOverlappingNodes ( bool on )
 {
 	m_ui.graphCanvas->setRepelOverlappingNodes(on);
-	if (on) ++m_repel_overlapping_nodes;
+	if (on) {
+		++m_repel_overlapping_nodes;
+		scheduleRefresh();
+	}
 }
 
 
@@ -1280,8 +1328,10 @@ void qpwgraph_main::added ( qpwgraph_node *node )
 
 void qpwgraph_main::updated ( qpwgraph_node */*node*/ )
 {
-	if (m_ui.graphCanvas->isRepelOverlappingNodes())
+	if (m_ui.graphCanvas->isRepelOverlappingNodes()) {
 		++m_repel_overlapping_nodes;
+		scheduleRefresh();
+	}
 }
 
 
@@ -1306,43 +1356,15 @@ void qpwgraph_main::removed ( qpwgraph_node */*node*/ )
 
 
 // Port (dis)connection slots.
-void qpwgraph_main::connected ( qpwgraph_port *port1, qpwgraph_port *port2 )
+void qpwgraph_main::connected ( const qpwgraph_port::Pairs& pairs )
 {
-	if (qpwgraph_pipewire::isPortType(port1->portType())) {
-		if (m_pipewire)
-			m_pipewire->connectPorts(port1, port2, true);
-		pipewire_changed();
-	}
-#ifdef CONFIG_ALSA_MIDI
-	else
-	if (qpwgraph_alsamidi::isPortType(port1->portType())) {
-		if (m_alsamidi)
-			m_alsamidi->connectPorts(port1, port2, true);
-		alsamidi_changed();
-	}
-#endif
-
-	stabilize();
+	connectPorts(pairs, true);
 }
 
 
-void qpwgraph_main::disconnected ( qpwgraph_port *port1, qpwgraph_port *port2 )
+void qpwgraph_main::disconnected ( const qpwgraph_port::Pairs& pairs )
 {
-	if (qpwgraph_pipewire::isPortType(port1->portType())) {
-		if (m_pipewire)
-			m_pipewire->connectPorts(port1, port2, false);
-		pipewire_changed();
-	}
-#ifdef CONFIG_ALSA_MIDI
-	else
-	if (qpwgraph_alsamidi::isPortType(port1->portType())) {
-		if (m_alsamidi)
-			m_alsamidi->connectPorts(port1, port2, false);
-		alsamidi_changed();
-	}
-#endif
-
-	stabilize();
+	connectPorts(pairs, false);
 }
 
 
@@ -1379,6 +1401,7 @@ void qpwgraph_main::renamed ( qpwgraph_item *item, const QString& name )
 void qpwgraph_main::changed (void)
 {
 	++m_thumb_update;
+	scheduleRefresh();
 
 	stabilize();
 }
@@ -1388,12 +1411,46 @@ void qpwgraph_main::changed (void)
 void qpwgraph_main::pipewire_changed (void)
 {
 	++m_pipewire_changed;
+	scheduleRefresh();
 }
 
 
 void qpwgraph_main::alsamidi_changed (void)
 {
 	++m_alsamidi_changed;
+	scheduleRefresh();
+}
+
+
+// PipeWire (dis)connection results slot.
+void qpwgraph_main::pipewire_connectResult (
+	uint port1_id, uint port2_id, bool is_connect, int res )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qpwgraph_main::pipewire_connectResult(%u, %u, %d, %d)",
+		port1_id, port2_id, int(is_connect), res);
+#endif
+
+	if (res < 0) {
+		// Port names, if still around (otherwise their ids)...
+		QString port1_name, port2_name;
+		if (m_pipewire) {
+			port1_name = m_pipewire->portName(port1_id);
+			port2_name = m_pipewire->portName(port2_id);
+		}
+		if (port1_name.isEmpty())
+			port1_name = QString::number(port1_id);
+		if (port2_name.isEmpty())
+			port2_name = QString::number(port2_id);
+		const QString& text = (is_connect
+			? tr("Connect %1 to %2 failed: %3.")
+			: tr("Disconnect %1 from %2 failed: %3."));
+		m_ui.StatusBar->showMessage(text
+			.arg(port1_name).arg(port2_name)
+			.arg(qt_error_string(-res)), 3000);
+	}
+
+	pipewire_changed();
 }
 
 
@@ -1401,10 +1458,14 @@ void qpwgraph_main::alsamidi_changed (void)
 void qpwgraph_main::refresh (void)
 {
 	if (m_ui.graphCanvas->isBusy()) {
-		QTimer::singleShot(1200, this, SLOT(refresh()));
+		m_refresh_busy = true;
+		m_refresh_elapsed.start();
+		m_refresh_timer->start(BUSY_REFRESH_DELAY);
 		return;
 	}
 
+	m_refresh_busy = false;
+
 	int nchanged = 0;
 
 	if (m_pipewire_changed > 0) {
@@ -1425,7 +1486,7 @@ void qpwgraph_main::refresh (void)
 	if (nchanged > 0) {
 		qpwgraph_patchbay *patchbay = m_ui.graphCanvas->patchbay();
 		if (patchbay && patchbay->isActivated())
-			patchbay->scan();
+			patchbay->scanPending();
 		stabilize();
 	}
 	else
@@ -1442,7 +1503,33 @@ void qpwgraph_main::refresh (void)
 			m_thumb->updateView();
 	}
 
-	QTimer::singleShot(300, this, SLOT(refresh()));
+	// Still pending (eg. while updating items)?
+	if (m_pipewire_changed > 0
+		|| m_alsamidi_changed > 0
+		|| m_repel_overlapping_nodes > 0
+		|| m_thumb_update > 0)
+		scheduleRefresh();
+}
+
+
+// Refresh cycle scheduler: coalesces bursts of change notifications
+// into one single refresh, though never later than a maximum latency
+// since the first one; otherwise sleeps while there's nothing to do.
+// A busy back-off (eg. while dragging or renaming) is never cut short.
+void qpwgraph_main::scheduleRefresh (void)
+{
+	if (m_refresh_timer->isActive()) {
+		if (m_refresh_busy)
+			return;
+		const int max_latency
+			= qMax(int(MAX_REFRESH_LATENCY), m_refresh_delay);
+		const int latency = int(m_refresh_elapsed.elapsed());
+		m_refresh_timer->start(qBound(0,
+			max_latency - latency, m_refresh_delay));
+	} else {
+		m_refresh_elapsed.start();
+		m_refresh_timer->start(m_refresh_delay);
+	}
 }
 
 
@@ -1638,7 +1725,10 @@ QString qpwgraph_main::patchbayFileExt (void) const
 
 QString qpwgraph_main::patchbayFileFilter (void) const
 {
-	return tr("Patchbay files (*.%1)").arg(patchbayFileExt()) + ";;"
+	const QString& binary_ext
+		= qpwgraph_patchbay::binaryFileExt();
+	return tr("Patchbay files (*.%1 *.%2)").arg(patchbayFileExt()).arg(binary_ext) + ";;"
+		 + tr("Compact patchbay files (*.%1)").arg(binary_ext) + ";;"
 		 + tr("All files (*.*)");
 }
 
@@ -1772,6 +1862,7 @@ void qpwgraph_main::changeEvent ( QEvent *event )
 void qpwgraph_main::showEvent ( QShowEvent *event )
 {
 	++m_thumb_update;
+	scheduleRefresh();
 
 	QMainWindow::showEvent(event);
 #ifdef CONFIG_SYSTEM_TRAY
@@ -1921,6 +2012,45 @@ void qpwgraph_main::updatePatchbayNames (void)
 }
 
 
+// Port (dis)connections dispatcher (grouped per sect).
+void qpwgraph_main::connectPorts (
+	const qpwgraph_port::Pairs& pairs, bool is_connect )
+{
+	qpwgraph_port::Pairs pipewire_pairs;
+#ifdef CONFIG_ALSA_MIDI
+	qpwgraph_port::Pairs alsamidi_pairs;
+#endif
+
+	foreach (const qpwgraph_port::Pair& pair, pairs) {
+		qpwgraph_port *port1 = pair.first;
+		if (port1 == nullptr)
+			continue;
+		if (qpwgraph_pipewire::isPortType(port1->portType()))
+			pipewire_pairs.append(pair);
+	#ifdef CONFIG_ALSA_MIDI
+		else
+		if (qpwgraph_alsamidi::isPortType(port1->portType()))
+			alsamidi_pairs.append(pair);
+	#endif
+	}
+
+	if (!pipewire_pairs.isEmpty()) {
+		if (m_pipewire)
+			m_pipewire->connectPorts(pipewire_pairs, is_connect);
+		pipewire_changed();
+	}
+#ifdef CONFIG_ALSA_MIDI
+	if (!alsamidi_pairs.isEmpty()) {
+		if (m_alsamidi)
+			m_alsamidi->connectPorts(alsamidi_pairs, is_connect);
+		alsamidi_changed();
+	}
+#endif
+
+	stabilize();
+}
+
+
 // Item sect predicate.
 qpwgraph_sect *qpwgraph_main::item_sect ( qpwgraph_item *item ) const
 {
@@ -24,6 +24,8 @@
 
 #include "ui_qpwgraph_main.h"
 
+#include <QElapsedTimer>
+
 
 // Forward decls.
 class qpwgraph_application;
@@ -90,8 +92,8 @@ protected slots:
 	void removed(qpwgraph_node *node);
 
 	// Port (dis)connection slots.
-	void connected(qpwgraph_port *port1, qpwgraph_port *port2);
-	void disconnected(qpwgraph_port *port1, qpwgraph_port *port2);
+	void connected(const qpwgraph_port::Pairs& pairs);
+	void disconnected(const qpwgraph_port::Pairs& pairs);
 
 	void connected(qpwgraph_connect *connect);
 
@@ -105,7 +107,11 @@ protected slots:
 	void pipewire_changed();
 	void alsamidi_changed();
 
-	// Pseudo-asynchronous timed refreshner.
+	// PipeWire (dis)connection results slot.
+	void pipewire_connectResult(
+		uint port1_id, uint port2_id, bool is_connect, int res);
+
+	// Pseudo-asynchronous event-driven refreshner.
 	void refresh();
 
 	// Graph selection change slot.
@@ -224,6 +230,12 @@ protected:
 	// Item sect predicate.
 	qpwgraph_sect *item_sect(qpwgraph_item *item) const;
 
+	// Port (dis)connections dispatcher (grouped per sect).
+	void connectPorts(const qpwgraph_port::Pairs& pairs, bool is_connect);
+
+	// Refresh cycle scheduler (debounced, latency capped).
+	void scheduleRefresh();
+
 	// Restore/save whole form state...
 	void restoreState();
 	void saveState();
@@ -268,6 +280,11 @@ private:
 	QActionGroup *m_thumb_mode;
 	qpwgraph_thumb *m_thumb;
 	int m_thumb_update;
+
+	QTimer *m_refresh_timer;
+	QElapsedTimer m_refresh_elapsed;
+	int m_refresh_delay;
+	bool m_refresh_busy;
 };
 
 
@@ -21,6 +21,8 @@
 
 #include "qpwgraph_node.h"
 
+#include "qpwgraph_shadow.h"
+
 #include <QGraphicsScene>
 
 #include <QStyleOptionGraphicsItem>
@@ -30,8 +32,6 @@
 
 #include <QLinearGradient>
 
-#include <QGraphicsDropShadowEffect>
-
 #include <algorithm>
 
 
@@ -43,7 +43,8 @@ qpwgraph_node::qpwgraph_node (
 	uint id, const QString& name, qpwgraph_item::Mode mode, uint type )
 	: qpwgraph_item(nullptr),
 		m_id(id), m_name(name), m_mode(mode), m_type(type),
-		m_num(0), m_name_ex(false), m_label_ex(false)
+		m_num(0), m_name_ex(false), m_label_ex(false),
+		m_ports_edit(0), m_ports_dirty(false), m_simplified(false)
 {
 	QGraphicsPathItem::setZValue(0.0);
 
@@ -67,20 +68,15 @@ qpwgraph_node::qpwgraph_node (
 	m_pixmap = new QGraphicsPixmapItem(this);
 	m_text = new QGraphicsTextItem(this);
 
+	m_shadow = new qpwgraph_shadow(this);
+	updateShadow();
+
 	QGraphicsPathItem::setFlag(QGraphicsItem::ItemIsMovable);
 	QGraphicsPathItem::setFlag(QGraphicsItem::ItemIsSelectable);
 
 	setNodeTitle(QString());
 
-	const bool is_darkest = (base_value < 24);
-	QColor shadow_color = (is_darkest ? Qt::white : Qt::black);
-	shadow_color.setAlpha(180);
-
-	QGraphicsDropShadowEffect *effect = new QGraphicsDropShadowEffect();
-	effect->setColor(shadow_color);
-	effect->setBlurRadius(is_darkest ? 8 : 16);
-	effect->setOffset(is_darkest ? 0 : 2);
-	QGraphicsPathItem::setGraphicsEffect(effect);
+	updateNodeNameAtom();
 
 	qpwgraph_item::raise();
 }
@@ -110,6 +106,8 @@ void qpwgraph_node::setNodeName ( const QString& name )
 {
 	m_name = name;
 
+	updateNodeNameAtom();
+
 	QGraphicsPathItem::setToolTip(nodeNameLabelEx());
 }
 
@@ -169,6 +167,8 @@ void qpwgraph_node::setNodeNum ( uint num )
 {
 	m_num = num;
 
+	updateNodeNameAtom();
+
 	setNodeTitle(QString()); // reset title.
 }
 
@@ -249,6 +249,8 @@ const QString& qpwgraph_node::nodePrefix (void) const
 void qpwgraph_node::setNodeNameEx ( bool name_ex )
 {
 	m_name_ex = name_ex;
+
+	updateNodeNameAtom();
 }
 
 bool qpwgraph_node::isNodeNameEx (void) const
@@ -263,6 +265,19 @@ QString qpwgraph_node::nodeNameEx (void) const
 }
 
 
+const qpwgraph_atom& qpwgraph_node::nodeNameAtom (void) const
+{
+	return m_name_atom;
+}
+
+
+// Interned node name (as in nodeNameEx) updater.
+void qpwgraph_node::updateNodeNameAtom (void)
+{
+	m_name_atom = qpwgraph_atom(nodeNameEx());
+}
+
+
 void qpwgraph_node::setNodeLabelEx ( bool label_ex )
 {
 	m_label_ex = label_ex;
@@ -300,6 +315,8 @@ qpwgraph_port *qpwgraph_node::addPort (
 	m_port_ids.insert(qpwgraph_port::PortIdKey(port), port);
 	m_port_names.insert(qpwgraph_port::PortNameKey(port), port);
 
+	port->setSimplified(m_simplified);
+
 	updatePath();
 
 	return port;
@@ -354,6 +371,18 @@ qpwgraph_port *qpwgraph_node::findPort (
 
 qpwgraph_port *qpwgraph_node::findPort (
 	const QString& name, qpwgraph_item::Mode mode, uint type )
+{
+	// Never interned, never named...
+	const qpwgraph_atom& atom = qpwgraph_atom::lookup(name);
+	if (atom.isNull())
+		return nullptr;
+
+	return m_port_names.value(qpwgraph_port::PortNameKey(atom, mode, type), nullptr);
+}
+
+
+qpwgraph_port *qpwgraph_node::findPort (
+	const qpwgraph_atom& name, qpwgraph_item::Mode mode, uint type )
 {
 	return m_port_names.value(qpwgraph_port::PortNameKey(name, mode, type), nullptr);
 }
@@ -390,6 +419,12 @@ void qpwgraph_node::resetPorts (void)
 // Path/shape updater.
 void qpwgraph_node::updatePath (void)
 {
+	// Deferred till commit?...
+	if (m_ports_edit > 0) {
+		m_ports_dirty = true;
+		return;
+	}
+
 	const QRectF& rect = m_text->boundingRect();
 	int width = rect.width() / 2 + 24;
 	int wi, wo;
@@ -435,6 +470,31 @@ void qpwgraph_node::updatePath (void)
 	QPainterPath path;
 	path.addRoundedRect(0, 0, width, height + 6, 5, 5);
 	/*QGraphicsPathItem::*/setPath(path);
+
+	m_shadow->setRect(path.boundingRect());
+}
+
+
+// Port-edit transaction scope (nestable);
+// path/shape updates are deferred till commit.
+void qpwgraph_node::beginPortsEdit (void)
+{
+	++m_ports_edit;
+}
+
+
+void qpwgraph_node::commitPortsEdit (void)
+{
+	if (m_ports_edit > 0 && --m_ports_edit == 0 && m_ports_dirty) {
+		m_ports_dirty = false;
+		updatePath();
+	}
+}
+
+
+bool qpwgraph_node::isPortsEdit (void) const
+{
+	return (m_ports_edit > 0);
 }
 
 
@@ -465,11 +525,19 @@ void qpwgraph_node::paint ( QPainter *painter,
 		node_color = background;
 	}
 	node_color.setAlpha(180);
-	node_grad.setColorAt(0.6, node_color);
-	node_grad.setColorAt(1.0, node_color.darker(120));
-	painter->setBrush(node_grad);
 
-	painter->drawPath(QGraphicsPathItem::path());
+	const qreal lod = option->levelOfDetailFromTransform(
+		painter->worldTransform());
+	if (lod < g_simplify_zoom) {
+		// Simplified (flat) drawing...
+		painter->setBrush(node_color);
+		painter->drawRect(node_rect);
+	} else {
+		node_grad.setColorAt(0.6, node_color);
+		node_grad.setColorAt(1.0, node_color.darker(120));
+		painter->setBrush(node_grad);
+		painter->drawPath(QGraphicsPathItem::path());
+	}
 
 	m_pixmap->setPos(node_rect.x() + 4, node_rect.y() + 4);
 
@@ -499,4 +567,50 @@ QRectF qpwgraph_node::editorRect (void) const
 }
 
 
+// Level-of-detail mode (no text, icon nor effects when zoomed out).
+void qpwgraph_node::setSimplified ( bool simplified )
+{
+	if (m_simplified == simplified)
+		return;
+
+	m_simplified = simplified;
+
+	m_pixmap->setVisible(!m_simplified);
+	m_text->setVisible(!m_simplified);
+
+	updateShadow();
+
+	foreach (qpwgraph_port *port, m_ports)
+		port->setSimplified(m_simplified);
+}
+
+
+bool qpwgraph_node::isSimplified (void) const
+{
+	return m_simplified;
+}
+
+
+// Drop-shadow visibility updater.
+void qpwgraph_node::updateShadow (void)
+{
+	m_shadow->setVisible(!m_simplified && qpwgraph_shadow::isShadowsEnabled());
+}
+
+
+// Level-of-detail zoom threshold (simplified drawing below).
+//
+qreal qpwgraph_node::g_simplify_zoom = 0.5;
+
+void qpwgraph_node::setSimplifyZoom ( qreal zoom )
+{
+	g_simplify_zoom = zoom;
+}
+
+qreal qpwgraph_node::simplifyZoom (void)
+{
+	return g_simplify_zoom;
+}
+
+
 // end of qpwgraph_node.cpp
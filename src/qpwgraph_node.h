@@ -31,6 +31,8 @@
 // Forward decls.
 class QStyleOptionGraphicsItem;
 
+class qpwgraph_shadow;
+
 
 //----------------------------------------------------------------------------
 // qpwgraph_node -- Node graphics item.
@@ -81,6 +83,7 @@ public:
 	void setNodeNameEx(bool name_ex);
 	bool isNodeNameEx() const;
 	QString nodeNameEx() const;
+	const qpwgraph_atom& nodeNameAtom() const;
 
 	void setNodeLabelEx(bool label_ex);
 	bool isNodeLabelEx() const;
@@ -98,6 +101,7 @@ public:
 	// Port finder (by id/name, mode and type)
 	qpwgraph_port *findPort(uint id, Mode mode, uint type = 0);
 	qpwgraph_port *findPort(const QString& name, Mode mode, uint type = 0);
+	qpwgraph_port *findPort(const qpwgraph_atom& name, Mode mode, uint type = 0);
 
 	// Port-list accessor.
 	const QList<qpwgraph_port *>& ports() const;
@@ -108,6 +112,24 @@ public:
 	// Path/shape updater.
 	void updatePath();
 
+	// Port-edit transaction scope (nestable);
+	// path/shape updates are deferred till commit.
+	void beginPortsEdit();
+	void commitPortsEdit();
+
+	bool isPortsEdit() const;
+
+	// Level-of-detail mode (no text, icon nor effects when zoomed out).
+	void setSimplified(bool simplified);
+	bool isSimplified() const;
+
+	// Drop-shadow visibility updater.
+	void updateShadow();
+
+	// Level-of-detail zoom threshold (simplified drawing below).
+	static void setSimplifyZoom(qreal zoom);
+	static qreal simplifyZoom();
+
 	// Node hash key (by id).
 	class NodeIdKey : public IdKey
 	{
@@ -126,10 +148,10 @@ public:
 	{
 	public:
 		// Constructors.
-		NodeNameKey (const QString& name, Mode mode, uint type = 0)
+		NodeNameKey (const qpwgraph_atom& name, Mode mode, uint type = 0)
 			: NameKey(name, mode, type) {}
 		NodeNameKey(qpwgraph_node *node)
-			: NameKey(node->nodeNameEx(), node->nodeMode(), node->nodeType()) {}
+			: NameKey(node->nodeNameAtom(), node->nodeMode(), node->nodeType()) {}
 	};
 
 	typedef QMultiHash<NodeNameKey, qpwgraph_node *> NodeNames;
@@ -144,6 +166,9 @@ protected:
 
 	QVariant itemChange(GraphicsItemChange change, const QVariant& value);
 
+	// Interned node name (as in nodeNameEx) updater.
+	void updateNodeNameAtom();
+
 private:
 
 	// Instance variables.
@@ -162,12 +187,23 @@ private:
 	bool m_name_ex;
 	bool m_label_ex;
 
+	qpwgraph_atom m_name_atom;
+
 	QGraphicsPixmapItem *m_pixmap;
 	QGraphicsTextItem   *m_text;
 
+	qpwgraph_shadow     *m_shadow;
+
 	qpwgraph_port::PortIds   m_port_ids;
 	qpwgraph_port::PortNames m_port_names;
 	QList<qpwgraph_port *>   m_ports;
+
+	int  m_ports_edit;
+	bool m_ports_dirty;
+
+	bool m_simplified;
+
+	static qreal g_simplify_zoom;
 };
 
 
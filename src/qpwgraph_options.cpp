@@ -80,6 +80,16 @@ qpwgraph_options::qpwgraph_options ( qpwgraph_main *parent )
 		m_ui.AlsaMidiEnabledCheckBox->setChecked(
 			config->isAlsaMidiEnabled());
 	#endif
+		m_ui.RefreshDelaySpinBox->setValue(
+			config->refreshDelay());
+		m_ui.ArrangeNodesAnimatedCheckBox->setChecked(
+			config->isArrangeNodesAnimated());
+		m_ui.SimplifyNodesZoomSpinBox->setValue(
+			config->simplifyNodesZoom());
+		m_ui.SimplifyConnectsZoomSpinBox->setValue(
+			config->simplifyConnectsZoom());
+		m_ui.NodeShadowsCheckBox->setChecked(
+			config->isNodeShadows());
 		resetCustomColorThemes(config->customColorTheme());
 		resetCustomStyleThemes(config->customStyleTheme());
 	}
@@ -151,6 +161,21 @@ qpwgraph_options::qpwgraph_options ( qpwgraph_main *parent )
 		SIGNAL(stateChanged(int)),
 		SLOT(changed()));
 #endif
+	QObject::connect(m_ui.RefreshDelaySpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.ArrangeNodesAnimatedCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.SimplifyNodesZoomSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.SimplifyConnectsZoomSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.NodeShadowsCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
 
 	QObject::connect(m_ui.FilterNodesEnabledCheckBox,
 		SIGNAL(stateChanged(int)),
@@ -269,6 +294,16 @@ void qpwgraph_options::accept (void)
 		config->setAlsaMidiEnabled(
 			m_ui.AlsaMidiEnabledCheckBox->isChecked());
 	#endif
+		config->setRefreshDelay(
+			m_ui.RefreshDelaySpinBox->value());
+		config->setArrangeNodesAnimated(
+			m_ui.ArrangeNodesAnimatedCheckBox->isChecked());
+		config->setSimplifyNodesZoom(
+			m_ui.SimplifyNodesZoomSpinBox->value());
+		config->setSimplifyConnectsZoom(
+			m_ui.SimplifyConnectsZoomSpinBox->value());
+		config->setNodeShadows(
+			m_ui.NodeShadowsCheckBox->isChecked());
 		if (m_dirty_filter > 0) {
 			config->setFilterNodesEnabled(
 				m_ui.FilterNodesEnabledCheckBox->isChecked());
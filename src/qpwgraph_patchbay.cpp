@@ -31,48 +31,64 @@
 #include "qpwgraph_pipewire.h"
 #include "qpwgraph_alsamidi.h"
 
-#include <QDomDocument>
-#include <QTextStream>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QDataStream>
 #include <QFileInfo>
-
-
-// Deprecated QTextStreamFunctions/Qt namespaces workaround.
-#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
-#define endl	Qt::endl
-#endif
+#include <QVector>
 
 
 //----------------------------------------------------------------------------
 // qpwgraph_patchbay -- Persistant connections patchbay impl.
 
 
+// Minimum number of rule items table slots.
+#define MIN_ITEMS_SLOTS 16
+
+
 // Manage connection rules.
 bool qpwgraph_patchbay::Items::addItem ( const Item& item )
 {
-	bool ret = false;
+	if (findItem(item))
+		return false;
 
-	ConstIterator iter = constFind(item);
-	if (iter == constEnd()) {
-		insert(item, new Item(item));
-		ret = true;
-	}
+	// Keep it at most half full (incl. removed)...
+	if ((m_used + 1) * 2 > m_slots.count())
+		rehash(m_count + 1);
 
-	return ret;
+	const uint mask = m_slots.count() - 1;
+	uint i = item.hash & mask;
+	while (m_slots.at(i).index >= 0)
+		i = (i + 1) & mask;
+
+	Slot& slot = m_slots[i];
+	if (slot.index == -1)
+		++m_used;
+	slot.hash = item.hash;
+	slot.index = m_items.count();
+
+	m_items.append(item);
+	++m_count;
+
+	return true;
 }
 
 
 bool qpwgraph_patchbay::Items::removeItem ( const Item& item )
 {
-	bool ret = false;
+	const int i = findSlot(item.hash,
+		item.node_type, item.port_type,
+		item.node1, item.port1, item.node2, item.port2,
+		item.syntax);
+	if (i < 0)
+		return false;
 
-	ConstIterator iter = constFind(item);
-	if (iter != constEnd()) {
-		delete iter.value();
-		erase(iter);
-		ret = true;
-	}
+	Slot& slot = m_slots[i];
+	m_items[slot.index].node_type = 0;
+	slot.index = -2;
+	--m_count;
 
-	return ret;
+	return true;
 }
 
 
@@ -81,6 +97,8 @@ void qpwgraph_patchbay::Items::copyItems ( const Items& items )
 {
 	clearItems();
 
+	rehash(items.count());
+
 	Items::ConstIterator iter = items.constBegin();
 	const Items::ConstIterator& iter_end = items.constEnd();
 	for ( ; iter != iter_end; ++iter)
@@ -91,12 +109,120 @@ void qpwgraph_patchbay::Items::copyItems ( const Items& items )
 // Clear all patchbay rules and cache.
 void qpwgraph_patchbay::Items::clearItems (void)
 {
-	ConstIterator iter = constBegin();
-	const ConstIterator& iter_end = constEnd();
-	for ( ; iter != iter_end; ++iter)
-		delete iter.value();
+	m_items.clear();
+	m_slots.clear();
+
+	m_count = 0;
+	m_used = 0;
+}
+
+
+// Rules lookup.
+const qpwgraph_patchbay::Item *qpwgraph_patchbay::Items::findItem (
+	const Item& item ) const
+{
+	const int i = findSlot(item.hash,
+		item.node_type, item.port_type,
+		item.node1, item.port1, item.node2, item.port2,
+		item.syntax);
+
+	return (i < 0 ? nullptr : &(m_items.at(m_slots.at(i).index)));
+}
+
+
+const qpwgraph_patchbay::Item *qpwgraph_patchbay::Items::findItem (
+	qpwgraph_port *port1, qpwgraph_port *port2 ) const
+{
+	if (port1 == nullptr || port2 == nullptr)
+		return nullptr;
+
+	qpwgraph_node *node1 = port1->portNode();
+	qpwgraph_node *node2 = port2->portNode();
+	if (node1 == nullptr || node2 == nullptr)
+		return nullptr;
+
+	const uint node_type = node1->nodeType();
+	const uint port_type = port1->portType();
+
+	const qpwgraph_atom& node1_name = node1->nodeNameAtom();
+	const qpwgraph_atom& port1_name = port1->portNameAtom();
+	const qpwgraph_atom& node2_name = node2->nodeNameAtom();
+	const qpwgraph_atom& port2_name = port2->portNameAtom();
 
-	clear();
+	const uint hash = Item::hashOf(node_type, port_type,
+		node1_name, port1_name, node2_name, port2_name,
+		qpwgraph_patterns::Exact);
+
+	const int i = findSlot(hash, node_type, port_type,
+		node1_name, port1_name, node2_name, port2_name,
+		qpwgraph_patterns::Exact);
+
+	return (i < 0 ? nullptr : &(m_items.at(m_slots.at(i).index)));
+}
+
+
+// Slot probing: the slot holding the rule or else -1.
+int qpwgraph_patchbay::Items::findSlot ( uint hash, uint nt, uint pt,
+	const qpwgraph_atom& n1, const qpwgraph_atom& p1,
+	const qpwgraph_atom& n2, const qpwgraph_atom& p2,
+	qpwgraph_patterns::Syntax sx ) const
+{
+	if (m_count < 1)
+		return -1;
+
+	const uint mask = m_slots.count() - 1;
+	uint i = hash & mask;
+	for (;;) {
+		const Slot& slot = m_slots.at(i);
+		if (slot.index == -1)
+			break;
+		if (slot.index >= 0 && slot.hash == hash) {
+			const Item& item = m_items.at(slot.index);
+			if (item.node_type == nt
+				&& item.port_type == pt
+				&& item.syntax == sx
+				&& item.node1 == n1
+				&& item.port1 == p1
+				&& item.node2 == n2
+				&& item.port2 == p2)
+				return int(i);
+		}
+		i = (i + 1) & mask;
+	}
+
+	return -1;
+}
+
+
+// Resize and compact (drops all tombstones).
+void qpwgraph_patchbay::Items::rehash ( int count )
+{
+	int nslots = MIN_ITEMS_SLOTS;
+	while (nslots < count * 2)
+		nslots <<= 1;
+
+	QVector<Item> items;
+	items.reserve(count);
+
+	const Slot empty = { 0, -1 };
+	m_slots.fill(empty, nslots);
+	m_used = 0;
+
+	const uint mask = nslots - 1;
+	foreach (const Item& item, m_items) {
+		if (item.node_type == 0)
+			continue;
+		uint i = item.hash & mask;
+		while (m_slots.at(i).index >= 0)
+			i = (i + 1) & mask;
+		Slot& slot = m_slots[i];
+		slot.hash = item.hash;
+		slot.index = items.count();
+		items.append(item);
+		++m_used;
+	}
+
+	m_items = items;
 }
 
 
@@ -104,6 +230,15 @@ void qpwgraph_patchbay::clear (void)
 {
 	m_items.clearItems();
 
+	m_index1.clear();
+	m_index2.clear();
+	m_patterns.clear();
+	m_index_dirty = true;
+
+	m_pending1.clear();
+	m_pending2.clear();
+	m_pending_all = false;
+
 	m_dirty = 0;
 }
 
@@ -130,13 +265,14 @@ void qpwgraph_patchbay::snap (void)
 					qpwgraph_node *node1 = port1->portNode();
 					qpwgraph_node *node2 = port2->portNode();
 					if (node1 && node2) {
-						m_items.addItem(Item(
-							node1->nodeType(),
-							port1->portType(),
-							node1->nodeNameEx(),
-							port1->portName(),
-							node2->nodeNameEx(),
-							port2->portName()));
+						if (m_items.addItem(Item(
+								node1->nodeType(),
+								port1->portType(),
+								node1->nodeNameAtom(),
+								port1->portNameAtom(),
+								node2->nodeNameAtom(),
+								port2->portNameAtom())))
+							m_index_dirty = true;
 					}
 				}
 			}
@@ -145,6 +281,11 @@ void qpwgraph_patchbay::snap (void)
 }
 
 
+// Compact binary file format identification.
+#define BINARY_MAGIC	0x51505742	// "QPWB"
+#define BINARY_VERSION	1
+
+
 // Patchbay rules file I/O methods.
 bool qpwgraph_patchbay::load ( const QString& filename )
 {
@@ -153,121 +294,277 @@ bool qpwgraph_patchbay::load ( const QString& filename )
 	if (!file.open(QIODevice::ReadOnly))
 		return false;
 
-	QDomDocument doc("patchbay");
-	if (!doc.setContent(&file)) {
-		file.close();
+	// Either format, as told by its first bytes...
+	QDataStream ds(&file);
+	quint32 magic = 0;
+	ds >> magic;
+	file.seek(0);
+
+	const bool ret = (magic == BINARY_MAGIC
+		? loadBinary(&file)
+		: loadXml(&file));
+
+	file.close();
+
+	return ret;
+}
+
+
+bool qpwgraph_patchbay::save ( const QString& filename )
+{
+	if (m_canvas == nullptr)
 		return false;
-	}
+
+	QFile file(filename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	const QString& name = QFileInfo(filename).baseName();
+
+	const bool ret = (formatFromFile(filename) == Binary
+		? saveBinary(&file, name)
+		: saveXml(&file, name));
+
 	file.close();
 
-//	clear();
+	if (ret)
+		m_dirty = 0;
+
+	return ret;
+}
+
+
+// Patchbay rules file format, by file-name suffix.
+qpwgraph_patchbay::Format qpwgraph_patchbay::formatFromFile (
+	const QString& filename )
+{
+	if (QFileInfo(filename).suffix() == binaryFileExt())
+		return Binary;
+	else
+		return Xml;
+}
+
 
-	QDomElement edoc = doc.documentElement();
-	for (QDomNode nroot = edoc.firstChild();
-		 !nroot.isNull();
-		 	nroot = nroot.nextSibling()) {
-		QDomElement eroot = nroot.toElement();
-		if (eroot.isNull())
+QString qpwgraph_patchbay::binaryFileExt (void)
+{
+	return QString(PROJECT_NAME).toLower() + 'b';
+}
+
+
+// Patchbay rules XML file I/O (streaming).
+bool qpwgraph_patchbay::loadXml ( QIODevice *device )
+{
+	QXmlStreamReader xml(device);
+
+	if (!xml.readNextStartElement()
+		|| xml.name() != QLatin1String("patchbay"))
+		return false;
+
+#ifdef CONFIG_CLEANUP_NODE_NAMES
+	const bool cleanup
+		= (xml.attributes().value("version").toString() < "0.5.0");
+#endif
+
+	while (xml.readNextStartElement()) {
+		if (xml.name() != QLatin1String("items")) {
+			xml.skipCurrentElement();
 			continue;
-	#ifdef CONFIG_CLEANUP_NODE_NAMES
-		const bool cleanup
-			= (eroot.attribute("version") < "0.5.0");
-	#endif
-		if (eroot.tagName() == "items") {
-			for (QDomNode nitem = eroot.firstChild();
-				!nitem.isNull();
-					 nitem = nitem.nextSibling()) {
-				QDomElement eitem = nitem.toElement();
-				if (eitem.isNull())
-					continue;
-				if (eitem.tagName() == "item") {
-					const uint node_type = nodeTypeFromText(eitem.attribute("node-type"));
-					const uint port_type = portTypeFromText(eitem.attribute("port-type"));
-					QString node1, port1, node2, port2;
-					for (QDomNode nitem2 = eitem.firstChild();
-						!nitem2.isNull();
-					 		nitem2 = nitem2.nextSibling()) {
-						QDomElement eitem2 = nitem2.toElement();
-						if (eitem2.isNull())
-							continue;
-						if (eitem2.tagName() == "output") {
-							node1 = eitem2.attribute("node");
-							port1 = eitem2.attribute("port");
-						}
-						else
-						if (eitem2.tagName() == "input") {
-							node2 = eitem2.attribute("node");
-							port2 = eitem2.attribute("port");
-						}
-					}
-				#ifdef CONFIG_CLEANUP_NODE_NAMES
-					if (cleanup) { // FIXME: Cleanup legacy node names...
-						if (qpwgraph_canvas::cleanupNodeName(node1))
-							++m_dirty;
-						if (qpwgraph_canvas::cleanupNodeName(node2))
-							++m_dirty;
-					}
-				#endif
-					if (node_type > 0 && port_type > 0
-						&& !node1.isEmpty() && !port1.isEmpty()
-						&& !node2.isEmpty() && !port2.isEmpty()) {
-						m_items.addItem(Item(
-							node_type, port_type,
-							node1, port1, node2, port2));
-					}
+		}
+		while (xml.readNextStartElement()) {
+			if (xml.name() != QLatin1String("item")) {
+				xml.skipCurrentElement();
+				continue;
+			}
+			const QXmlStreamAttributes& attrs = xml.attributes();
+			const uint node_type
+				= nodeTypeFromText(attrs.value("node-type").toString());
+			const uint port_type
+				= portTypeFromText(attrs.value("port-type").toString());
+			const qpwgraph_patterns::Syntax syntax
+				= qpwgraph_patterns::syntaxFromText(attrs.value("match").toString());
+			QString node1, port1, node2, port2;
+			while (xml.readNextStartElement()) {
+				const QXmlStreamAttributes& attrs2 = xml.attributes();
+				if (xml.name() == QLatin1String("output")) {
+					node1 = attrs2.value("node").toString();
+					port1 = attrs2.value("port").toString();
+				}
+				else
+				if (xml.name() == QLatin1String("input")) {
+					node2 = attrs2.value("node").toString();
+					port2 = attrs2.value("port").toString();
 				}
+				xml.skipCurrentElement();
+			}
+		#ifdef CONFIG_CLEANUP_NODE_NAMES
+			if (cleanup && syntax == qpwgraph_patterns::Exact) {
+				// FIXME: Cleanup legacy node names...
+				if (qpwgraph_canvas::cleanupNodeName(node1))
+					++m_dirty;
+				if (qpwgraph_canvas::cleanupNodeName(node2))
+					++m_dirty;
+			}
+		#endif
+			if (node_type > 0 && port_type > 0
+				&& !node1.isEmpty() && !port1.isEmpty()
+				&& !node2.isEmpty() && !port2.isEmpty()) {
+				m_items.addItem(Item(
+					node_type, port_type,
+					node1, port1, node2, port2, syntax));
+				m_index_dirty = true;
 			}
 		}
 	}
 
-	return true;
+	return !xml.hasError();
 }
 
 
-bool qpwgraph_patchbay::save ( const QString& filename )
+bool qpwgraph_patchbay::saveXml (
+	QIODevice *device, const QString& name ) const
 {
-	if (m_canvas == nullptr)
-		return false;
+	QXmlStreamWriter xml(device);
+	xml.setAutoFormatting(true);
+	xml.setAutoFormattingIndent(1);
 
-	QFileInfo fi(filename);
-	const char *root_name = "patchbay";
-	QDomDocument doc(root_name);
-	QDomElement eroot = doc.createElement(root_name);
-	eroot.setAttribute("name", fi.baseName());
-	eroot.setAttribute("version", PROJECT_VERSION);
-	doc.appendChild(eroot);
+	xml.writeStartDocument();
+	xml.writeDTD("<!DOCTYPE patchbay>");
+	xml.writeStartElement("patchbay");
+	xml.writeAttribute("name", name);
+	xml.writeAttribute("version", PROJECT_VERSION);
 
-	QDomElement eitems = doc.createElement("items");
+	xml.writeStartElement("items");
 	Items::ConstIterator iter = m_items.constBegin();
 	const Items::ConstIterator& iter_end = m_items.constEnd();
 	for ( ; iter != iter_end; ++iter) {
-		Item *item = iter.value();
-		QDomElement eitem = doc.createElement("item");
-		eitem.setAttribute("node-type", textFromNodeType(item->node_type));
-		eitem.setAttribute("port-type", textFromPortType(item->port_type));
-		QDomElement eitem1 = doc.createElement("output");
-		eitem1.setAttribute("node", item->node1);
-		eitem1.setAttribute("port", item->port1);
-		eitem.appendChild(eitem1);
-		QDomElement eitem2 = doc.createElement("input");
-		eitem2.setAttribute("node", item->node2);
-		eitem2.setAttribute("port", item->port2);
-		eitem.appendChild(eitem2);
-		eitems.appendChild(eitem);
+		const Item *item = iter.value();
+		xml.writeStartElement("item");
+		xml.writeAttribute("node-type", textFromNodeType(item->node_type));
+		xml.writeAttribute("port-type", textFromPortType(item->port_type));
+		if (item->syntax != qpwgraph_patterns::Exact)
+			xml.writeAttribute("match", qpwgraph_patterns::textFromSyntax(item->syntax));
+		xml.writeEmptyElement("output");
+		xml.writeAttribute("node", item->node1.name());
+		xml.writeAttribute("port", item->port1.name());
+		xml.writeEmptyElement("input");
+		xml.writeAttribute("node", item->node2.name());
+		xml.writeAttribute("port", item->port2.name());
+		xml.writeEndElement();
 	}
-	eroot.appendChild(eitems);
+	xml.writeEndElement();
 
-	QFile file(filename);
-	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	xml.writeEndElement();
+	xml.writeEndDocument();
+
+	return !xml.hasError();
+}
+
+
+// Patchbay rules compact binary file I/O (streaming):
+// a string table (type names, node and port names) followed
+// by the items, each one referring to those by index.
+bool qpwgraph_patchbay::loadBinary ( QIODevice *device )
+{
+	QDataStream ds(device);
+	ds.setVersion(QDataStream::Qt_5_0);
+
+	quint32 magic = 0, version = 0;
+	ds >> magic >> version;
+	if (magic != BINARY_MAGIC || version > BINARY_VERSION)
 		return false;
 
-	QTextStream ts(&file);
-	ts << doc.toString() << endl;
-	file.close();
+	QString name, project_version;
+	ds >> name >> project_version;
 
-	m_dirty = 0;
+	quint32 nstrings = 0;
+	ds >> nstrings;
+	QVector<qpwgraph_atom> strings;
+	for (quint32 i = 0; i < nstrings && ds.status() == QDataStream::Ok; ++i) {
+		QString text;
+		ds >> text;
+		strings.append(qpwgraph_atom(text));
+	}
 
-	return true;
+	quint32 nitems = 0;
+	ds >> nitems;
+	for (quint32 i = 0; i < nitems && ds.status() == QDataStream::Ok; ++i) {
+		quint32 k[6];
+		quint8 syntax = 0;
+		ds >> k[0] >> k[1] >> syntax >> k[2] >> k[3] >> k[4] >> k[5];
+		if (ds.status() != QDataStream::Ok)
+			break;
+		int j = 0;
+		for ( ; j < 6; ++j) {
+			if (k[j] >= quint32(strings.count()) || strings.at(k[j]).isEmpty())
+				break;
+		}
+		if (j < 6 || syntax > qpwgraph_patterns::RegExp)
+			continue;
+		const uint node_type = nodeTypeFromText(strings.at(k[0]));
+		const uint port_type = portTypeFromText(strings.at(k[1]));
+		if (node_type > 0 && port_type > 0) {
+			m_items.addItem(Item(
+				node_type, port_type,
+				strings.at(k[2]), strings.at(k[3]),
+				strings.at(k[4]), strings.at(k[5]),
+				qpwgraph_patterns::Syntax(syntax)));
+			m_index_dirty = true;
+		}
+	}
+
+	return (ds.status() == QDataStream::Ok);
+}
+
+
+bool qpwgraph_patchbay::saveBinary (
+	QIODevice *device, const QString& name ) const
+{
+	// Build the string table first...
+	QHash<QString, quint32> string_ids;
+	QVector<QString> strings;
+
+	QVector<quint32> ids;
+	ids.reserve(m_items.count() * 6);
+
+	Items::ConstIterator iter = m_items.constBegin();
+	const Items::ConstIterator& iter_end = m_items.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		const Item *item = iter.value();
+		const QString texts[6] = {
+			textFromNodeType(item->node_type),
+			textFromPortType(item->port_type),
+			item->node1, item->port1,
+			item->node2, item->port2 };
+		for (int j = 0; j < 6; ++j) {
+			QHash<QString, quint32>::ConstIterator iter2
+				= string_ids.constFind(texts[j]);
+			if (iter2 == string_ids.constEnd()) {
+				iter2 = string_ids.insert(texts[j], strings.count());
+				strings.append(texts[j]);
+			}
+			ids.append(iter2.value());
+		}
+	}
+
+	QDataStream ds(device);
+	ds.setVersion(QDataStream::Qt_5_0);
+
+	ds << quint32(BINARY_MAGIC) << quint32(BINARY_VERSION);
+	ds << name << QString(PROJECT_VERSION);
+
+	ds << quint32(strings.count());
+	foreach (const QString& text, strings)
+		ds << text;
+
+	ds << quint32(m_items.count());
+	int k = 0;
+	for (iter = m_items.constBegin(); iter != iter_end; ++iter, k += 6) {
+		const Item *item = iter.value();
+		ds << ids.at(k + 0) << ids.at(k + 1) << quint8(item->syntax)
+		   << ids.at(k + 2) << ids.at(k + 3) << ids.at(k + 4) << ids.at(k + 5);
+	}
+
+	return (ds.status() == QDataStream::Ok);
 }
 
 
@@ -277,116 +574,254 @@ bool qpwgraph_patchbay::scan (void)
 	if (m_canvas == nullptr)
 		return false;
 
-	QGraphicsScene *scene = m_canvas->scene();
-	if (scene == nullptr)
+	m_pending1.clear();
+	m_pending2.clear();
+	m_pending_all = false;
+
+	updateIndex();
+
+	// Only the rules whose both endpoint nodes are present...
+	QSet<NodeKey> keys1, keys2;
+	foreach (qpwgraph_node *node, m_canvas->nodes()) {
+		const NodeKey key(node->nodeType(), node->nodeNameAtom());
+		if (node->nodeMode() & qpwgraph_item::Output)
+			keys1.insert(key);
+		if (node->nodeMode() & qpwgraph_item::Input)
+			keys2.insert(key);
+	}
+
+	QSet<Item> items;
+	foreach (const NodeKey& key1, keys1) {
+		Index::ConstIterator iter = m_index1.constFind(key1);
+		const Index::ConstIterator& iter_end = m_index1.constEnd();
+		for ( ; iter != iter_end && iter.key() == key1; ++iter) {
+			const Item *item = iter.value();
+			if (keys2.contains(NodeKey(item->node_type, item->node2)))
+				items.insert(*item);
+		}
+	}
+
+	// Pattern rules, expanded for every output node...
+	if (!m_patterns.isEmpty()) {
+		foreach (qpwgraph_node *node, m_canvas->nodes()) {
+			if (node->nodeMode() & qpwgraph_item::Output)
+				expandPatterns(node, items);
+		}
+	}
+
+	return scanItems(items);
+}
+
+
+// Execute and apply only the rules touching the given nodes.
+bool qpwgraph_patchbay::scanNodes ( const QList<qpwgraph_node *>& nodes )
+{
+	QSet<NodeKey> keys1, keys2;
+	foreach (qpwgraph_node *node, nodes) {
+		const NodeKey key(node->nodeType(), node->nodeNameAtom());
+		if (node->nodeMode() & qpwgraph_item::Output)
+			keys1.insert(key);
+		if (node->nodeMode() & qpwgraph_item::Input)
+			keys2.insert(key);
+	}
+
+	return scanKeys(keys1, keys2);
+}
+
+
+// Incremental scan: mark a node as changed (pending).
+void qpwgraph_patchbay::changeNode ( qpwgraph_node *node )
+{
+	if (!m_activated || m_pending_all || node == nullptr)
+		return;
+
+	const NodeKey key(node->nodeType(), node->nodeNameAtom());
+	if (node->nodeMode() & qpwgraph_item::Output)
+		m_pending1.insert(key);
+	if (node->nodeMode() & qpwgraph_item::Input)
+		m_pending2.insert(key);
+}
+
+
+bool qpwgraph_patchbay::isPending (void) const
+{
+	return m_pending_all || !m_pending1.isEmpty() || !m_pending2.isEmpty();
+}
+
+
+// Incremental scan: execute and apply only the rules touching
+// the pending (changed) nodes; all of them, if so required.
+bool qpwgraph_patchbay::scanPending (void)
+{
+	if (m_pending_all)
+		return scan();
+
+	if (m_pending1.isEmpty() && m_pending2.isEmpty())
 		return false;
 
-	QHash<Item, qpwgraph_connect *> disconnects;
+	const QSet<NodeKey> keys1 = m_pending1;
+	const QSet<NodeKey> keys2 = m_pending2;
+
+	m_pending1.clear();
+	m_pending2.clear();
+
+	return scanKeys(keys1, keys2);
+}
+
+
+// Execute and apply only the rules touching the given node keys.
+bool qpwgraph_patchbay::scanKeys (
+	const QSet<NodeKey>& keys1, const QSet<NodeKey>& keys2 )
+{
+	if (m_canvas == nullptr)
+		return false;
+
+	updateIndex();
+
+	QSet<Item> items;
+	foreach (const NodeKey& key1, keys1) {
+		Index::ConstIterator iter = m_index1.constFind(key1);
+		const Index::ConstIterator& iter_end = m_index1.constEnd();
+		for ( ; iter != iter_end && iter.key() == key1; ++iter)
+			items.insert(*iter.value());
+	}
+	foreach (const NodeKey& key2, keys2) {
+		Index::ConstIterator iter = m_index2.constFind(key2);
+		const Index::ConstIterator& iter_end = m_index2.constEnd();
+		for ( ; iter != iter_end && iter.key() == key2; ++iter)
+			items.insert(*iter.value());
+	}
+
+	// Pattern rules: input side names are only known after
+	// expansion, so any changed input node takes all outputs...
+	if (!m_patterns.isEmpty()) {
+		if (keys2.isEmpty()) {
+			foreach (const NodeKey& key1, keys1) {
+				foreach (qpwgraph_node *node, m_canvas->findNodes(
+						key1.node, qpwgraph_item::Output, key1.node_type))
+					expandPatterns(node, items);
+				foreach (qpwgraph_node *node, m_canvas->findNodes(
+						key1.node, qpwgraph_item::Duplex, key1.node_type))
+					expandPatterns(node, items);
+			}
+		} else {
+			foreach (qpwgraph_node *node, m_canvas->nodes()) {
+				if (node->nodeMode() & qpwgraph_item::Output)
+					expandPatterns(node, items);
+			}
+		}
+	}
+
+	return scanItems(items);
+}
+
+
+// Compiled rule index (re)builder (lazy).
+void qpwgraph_patchbay::updateIndex (void) const
+{
+	if (!m_index_dirty)
+		return;
+
+	m_index1.clear();
+	m_index2.clear();
+	m_patterns.clear();
+
+	m_index1.reserve(m_items.count());
+	m_index2.reserve(m_items.count());
 
 	Items::ConstIterator iter = m_items.constBegin();
 	const Items::ConstIterator& iter_end = m_items.constEnd();
 	for ( ; iter != iter_end; ++iter) {
-		Item *item = iter.value();
-		QList<qpwgraph_node *> nodes1
-			= m_canvas->findNodes(
-				item->node1,
-				qpwgraph_item::Output,
-				item->node_type);
-		if (nodes1.isEmpty())
-			nodes1 = m_canvas->findNodes(
-				item->node1,
-				qpwgraph_item::Duplex,
-				item->node_type);
-		if (nodes1.isEmpty())
+		const Item *item = iter.value();
+		if (item->syntax != qpwgraph_patterns::Exact) {
+			m_patterns.addRule(
+				item->node_type, item->port_type, item->syntax,
+				item->node1, item->port1, item->node2, item->port2, item);
 			continue;
-		foreach (qpwgraph_node *node1, nodes1) {
-			qpwgraph_port *port1
-				= node1->findPort(
-					item->port1,
-					qpwgraph_item::Output,
-					item->port_type);
-			if (port1 == nullptr)
+		}
+		m_index1.insert(NodeKey(item->node_type, item->node1), item);
+		m_index2.insert(NodeKey(item->node_type, item->node2), item);
+	}
+
+	m_index_dirty = false;
+}
+
+
+// Expand the pattern rules matching an output node,
+// into actual (exact) connection rules.
+void qpwgraph_patchbay::expandPatterns (
+	qpwgraph_node *node1, QSet<Item>& items ) const
+{
+	const uint node_type = node1->nodeType();
+	const QString& node1_name = node1->nodeNameAtom();
+
+	foreach (const qpwgraph_patterns::Rule *rule,
+			m_patterns.candidates(node_type, node1_name)) {
+		const QRegularExpressionMatch& m1 = rule->node1.match(node1_name);
+		if (!m1.hasMatch())
+			continue;
+		const QRegularExpression& rx2
+			= m_patterns.regexp(rule, rule->node2, m1);
+		QList<qpwgraph_node *> nodes2;
+		foreach (qpwgraph_node *node2, m_canvas->nodes()) {
+			if (node2->nodeType() == node_type
+				&& (node2->nodeMode() & qpwgraph_item::Input)
+				&& rx2.match(node2->nodeNameAtom().name()).hasMatch())
+				nodes2.append(node2);
+		}
+		if (nodes2.isEmpty())
+			continue;
+		foreach (qpwgraph_port *port1, node1->ports()) {
+			if (port1->portType() != rule->port_type
+				|| !port1->isOutput())
 				continue;
-			QList<qpwgraph_node *> nodes2
-				= m_canvas->findNodes(
-					item->node2,
-					qpwgraph_item::Input,
-					item->node_type);
-			if (nodes2.isEmpty())
-				nodes2 = m_canvas->findNodes(
-					item->node2,
-					qpwgraph_item::Duplex,
-					item->node_type);
-			if (nodes2.isEmpty())
+			const QRegularExpressionMatch& m2
+				= rule->port1.match(port1->portNameAtom().name());
+			if (!m2.hasMatch())
 				continue;
-			const bool node1_exclusive
-				= m_canvas->isMergerNodes(node1->nodeName());
+			const QRegularExpression& rx4
+				= m_patterns.regexp(rule, rule->port2, m2);
 			foreach (qpwgraph_node *node2, nodes2) {
-				qpwgraph_port *port2
-					= node2->findPort(
-						item->port2,
-						qpwgraph_item::Input,
-						item->port_type);
-				if (port2 == nullptr)
-					continue;
-				if (m_activated && (m_exclusive || node1_exclusive)) {
-					foreach (qpwgraph_connect *connect12, port1->connects()) {
-						qpwgraph_port *port12 = connect12->port2();
-						if (port12 == nullptr)
-							continue;
-						if (port12 != port2) {
-							qpwgraph_node *node12 = port12->portNode();
-							if (node12 == nullptr)
-								continue;
-							const Item item12(
-								node1->nodeType(),
-								port1->portType(),
-								node1->nodeNameEx(),
-								port1->portName(),
-								node12->nodeNameEx(),
-								port12->portName());
-							if (m_items.constFind(item12) == iter_end)
-								disconnects.insert(item12, connect12);
-						}
-					}
-					foreach (qpwgraph_connect *connect21, port2->connects()) {
-						qpwgraph_port *port21 = connect21->port1();
-						if (port21 == nullptr)
-							continue;
-						if (port21 != port1) {
-							qpwgraph_node *node21 = port21->portNode();
-							if (node21 == nullptr)
-								continue;
-							const Item item21(
-								node21->nodeType(),
-								port21->portType(),
-								node21->nodeNameEx(),
-								port21->portName(),
-								node2->nodeNameEx(),
-								port2->portName());
-							if (m_items.constFind(item21) == iter_end) {
-								disconnects.insert(item21, connect21);
-							}
-						}
-					}
-				}
-				qpwgraph_connect *connect12 = port1->findConnect(port2);
-				if (connect12 == nullptr && m_activated)
-					m_canvas->emitConnected(port1, port2);
-				else
-				if (!m_activated && m_canvas->isPatchbayAutoDisconnect()) {
-					const Item item12(
-						node1->nodeType(),
-						port1->portType(),
-						node1->nodeNameEx(),
-						port1->portName(),
-						node2->nodeNameEx(),
-						port2->portName());
-					disconnects.insert(item12, connect12);
+				foreach (qpwgraph_port *port2, node2->ports()) {
+					if (port2->portType() != rule->port_type
+						|| !port2->isInput()
+						|| !rx4.match(port2->portNameAtom().name()).hasMatch())
+						continue;
+					items.insert(Item(
+						node_type,
+						rule->port_type,
+						node1->nodeNameAtom(),
+						port1->portNameAtom(),
+						node2->nodeNameAtom(),
+						port2->portNameAtom()));
 				}
 			}
 		}
 	}
+}
+
+
+// Execute and apply a set of (exact) rules.
+bool qpwgraph_patchbay::scanItems ( const QSet<Item>& items )
+{
+	if (m_canvas == nullptr)
+		return false;
+
+	QGraphicsScene *scene = m_canvas->scene();
+	if (scene == nullptr)
+		return false;
+
+	QHash<Item, qpwgraph_connect *> disconnects;
+	qpwgraph_port::Pairs connects;
+
+	foreach (const Item& item, items)
+		scanItem(&item, disconnects, connects);
+
+	// Connect all in one go...
+	m_canvas->emitConnected(connects);
+
+	// Disconnect all in one go...
+	qpwgraph_port::Pairs disconnects2;
 
 	QHash<Item, qpwgraph_connect *>::ConstIterator iter2
 		= disconnects.constBegin();
@@ -395,13 +830,123 @@ bool qpwgraph_patchbay::scan (void)
 	for (; iter2 != iter2_end; ++iter2) {
 		qpwgraph_connect *connect = iter2.value();
 		if (connect)
-			m_canvas->emitDisconnected(connect->port1(), connect->port2());
+			disconnects2.append(
+				qpwgraph_port::Pair(connect->port1(), connect->port2()));
 	}
 
+	m_canvas->emitDisconnected(disconnects2);
+
 	return true;
 }
 
 
+// Execute one rule, collecting the (dis)connections.
+void qpwgraph_patchbay::scanItem ( const Item *item,
+	QHash<Item, qpwgraph_connect *>& disconnects,
+	qpwgraph_port::Pairs& connects ) const
+{
+	QList<qpwgraph_node *> nodes1
+		= m_canvas->findNodes(
+			item->node1,
+			qpwgraph_item::Output,
+			item->node_type);
+	if (nodes1.isEmpty())
+		nodes1 = m_canvas->findNodes(
+			item->node1,
+			qpwgraph_item::Duplex,
+			item->node_type);
+	if (nodes1.isEmpty())
+		return;
+	QList<qpwgraph_node *> nodes2
+		= m_canvas->findNodes(
+			item->node2,
+			qpwgraph_item::Input,
+			item->node_type);
+	if (nodes2.isEmpty())
+		nodes2 = m_canvas->findNodes(
+			item->node2,
+			qpwgraph_item::Duplex,
+			item->node_type);
+	if (nodes2.isEmpty())
+		return;
+	foreach (qpwgraph_node *node1, nodes1) {
+		qpwgraph_port *port1
+			= node1->findPort(
+				item->port1,
+				qpwgraph_item::Output,
+				item->port_type);
+		if (port1 == nullptr)
+			continue;
+		const bool node1_exclusive
+			= m_canvas->isMergerNodes(node1->nodeName());
+		foreach (qpwgraph_node *node2, nodes2) {
+			qpwgraph_port *port2
+				= node2->findPort(
+					item->port2,
+					qpwgraph_item::Input,
+					item->port_type);
+			if (port2 == nullptr)
+				continue;
+			if (m_activated && (m_exclusive || node1_exclusive)) {
+				foreach (qpwgraph_connect *connect12, port1->connects()) {
+					qpwgraph_port *port12 = connect12->port2();
+					if (port12 == nullptr)
+						continue;
+					if (port12 != port2) {
+						qpwgraph_node *node12 = port12->portNode();
+						if (node12 == nullptr)
+							continue;
+						const Item item12(
+							node1->nodeType(),
+							port1->portType(),
+							node1->nodeNameAtom(),
+							port1->portNameAtom(),
+							node12->nodeNameAtom(),
+							port12->portNameAtom());
+						if (!matchItem(item12))
+							disconnects.insert(item12, connect12);
+					}
+				}
+				foreach (qpwgraph_connect *connect21, port2->connects()) {
+					qpwgraph_port *port21 = connect21->port1();
+					if (port21 == nullptr)
+						continue;
+					if (port21 != port1) {
+						qpwgraph_node *node21 = port21->portNode();
+						if (node21 == nullptr)
+							continue;
+						const Item item21(
+							node21->nodeType(),
+							port21->portType(),
+							node21->nodeNameAtom(),
+							port21->portNameAtom(),
+							node2->nodeNameAtom(),
+							port2->portNameAtom());
+						if (!matchItem(item21)) {
+							disconnects.insert(item21, connect21);
+						}
+					}
+				}
+			}
+			qpwgraph_connect *connect12 = port1->findConnect(port2);
+			if (connect12 == nullptr && m_activated)
+				connects.append(qpwgraph_port::Pair(port1, port2));
+			else
+			if (!m_activated && m_canvas->isPatchbayAutoDisconnect()) {
+				const Item item12(
+					node1->nodeType(),
+					port1->portType(),
+					node1->nodeNameAtom(),
+					port1->portNameAtom(),
+					node2->nodeNameAtom(),
+					port2->portNameAtom());
+				disconnects.insert(item12, connect12);
+			}
+		}
+	}
+}
+
+
 // Update rules on demand.
 bool qpwgraph_patchbay::connectPorts (
 	qpwgraph_port *port1, qpwgraph_port *port2, bool is_connect )
@@ -417,17 +962,20 @@ bool qpwgraph_patchbay::connectPorts (
 		const Item item(
 			node1->nodeType(),
 			port1->portType(),
-			node1->nodeNameEx(),
-			port1->portName(),
-			node2->nodeNameEx(),
-			port2->portName());
+			node1->nodeNameAtom(),
+			port1->portNameAtom(),
+			node2->nodeNameAtom(),
+			port2->portNameAtom());
 		if (is_connect)
 			ret = m_items.addItem(item);
 		else
 			ret = m_items.removeItem(item);
 	}
 
-	if (ret) ++m_dirty;
+	if (ret) {
+		m_index_dirty = true;
+		++m_dirty;
+	}
 
 	return ret;
 }
@@ -439,31 +987,55 @@ bool qpwgraph_patchbay::connect ( qpwgraph_connect *connect, bool is_connect )
 }
 
 
+// Whether a connection is covered by any rule.
+bool qpwgraph_patchbay::matchItem ( const Item& item ) const
+{
+	if (m_items.contains(item))
+		return true;
+
+	updateIndex();
+
+	if (m_patterns.isEmpty())
+		return false;
+
+	return (m_patterns.match(
+		item.node_type, item.port_type,
+		item.node1, item.port1, item.node2, item.port2) != nullptr);
+}
+
+
 // Find a connection rule.
-qpwgraph_patchbay::Item *qpwgraph_patchbay::findConnectPorts (
+const qpwgraph_patchbay::Item *qpwgraph_patchbay::findConnectPorts (
 	qpwgraph_port *port1, qpwgraph_port *port2 ) const
 {
-	Item *ret = nullptr;
+	const Item *ret = m_items.findItem(port1, port2);
+	if (ret || port1 == nullptr || port2 == nullptr)
+		return ret;
+
+	updateIndex();
+
+	if (m_patterns.isEmpty())
+		return nullptr;
 
-	if (port1 && port2) {
-		qpwgraph_node *node1 = port1->portNode();
-		qpwgraph_node *node2 = port2->portNode();
-		if (node1 && node2) {
-			const Item item(
+	qpwgraph_node *node1 = port1->portNode();
+	qpwgraph_node *node2 = port2->portNode();
+	if (node1 && node2) {
+		const qpwgraph_patterns::Rule *rule
+			= m_patterns.match(
 				node1->nodeType(),
 				port1->portType(),
-				node1->nodeNameEx(),
-				port1->portName(),
-				node2->nodeNameEx(),
-				port2->portName());
-			ret = m_items.value(item, nullptr);
-		}
+				node1->nodeNameAtom(),
+				port1->portNameAtom(),
+				node2->nodeNameAtom(),
+				port2->portNameAtom());
+		if (rule)
+			ret = static_cast<const Item *> (rule->data);
 	}
 
 	return ret;
 }
 
-qpwgraph_patchbay::Item *qpwgraph_patchbay::findConnect (
+const qpwgraph_patchbay::Item *qpwgraph_patchbay::findConnect (
 	qpwgraph_connect *connect ) const
 {
 	return findConnectPorts(connect->port1(), connect->port2());
@@ -475,6 +1047,8 @@ void qpwgraph_patchbay::setItems ( const Items& items )
 {
 	m_items.copyItems(items);
 
+	m_index_dirty = true;
+	m_pending_all = true;
 	++m_dirty;
 
 	m_canvas->patchbayEdit();
@@ -23,16 +23,21 @@
 #define __qpwgraph_patchbay_h
 
 #include "qpwgraph_item.h"
+#include "qpwgraph_port.h"
+#include "qpwgraph_patterns.h"
 
 #include <QString>
 #include <QList>
 #include <QHash>
+#include <QSet>
+#include <QVector>
 
 
 // Forward decls.
+class QIODevice;
+
 class qpwgraph_canvas;
 class qpwgraph_connect;
-class qpwgraph_port;
 class qpwgraph_node;
 
 
@@ -45,7 +50,8 @@ public:
 
 	// Constructor.
 	qpwgraph_patchbay(qpwgraph_canvas *canvas) : m_canvas(canvas),
-		m_activated(false), m_exclusive(false), m_dirty(0) {}
+		m_activated(false), m_exclusive(false), m_dirty(0),
+		m_index_dirty(true), m_pending_all(false) {}
 
 	// Destructor.
 	~qpwgraph_patchbay() { clear(); }
@@ -71,13 +77,30 @@ public:
 	// Snapshot of all current graph connections...
 	void snap();
 
+	// Patchbay rules file formats.
+	enum Format { Xml = 0, Binary };
+
 	// Patchbay rules file I/O methods.
 	bool load(const QString& filename);
 	bool save(const QString& filename);
 
+	// Patchbay rules file format, by file-name suffix.
+	static Format formatFromFile(const QString& filename);
+	static QString binaryFileExt();
+
 	// Execute and apply rules to graph.
 	bool scan();
 
+	// Execute and apply only the rules touching the given nodes.
+	bool scanNodes(const QList<qpwgraph_node *>& nodes);
+
+	// Incremental scan: mark a node as changed (pending),
+	// then execute and apply only the rules touching those.
+	void changeNode(qpwgraph_node *node);
+
+	bool isPending() const;
+	bool scanPending();
+
 	// Update rules on demand.
 	bool connectPorts(qpwgraph_port *port1, qpwgraph_port *port2, bool is_connect);
 	bool connect(qpwgraph_connect *connect, bool is_connect);
@@ -88,16 +111,28 @@ public:
 	{
 		Item(uint nt, uint pt,
 			const QString& n1, const QString& p1,
-			const QString& n2, const QString& p2)
-			: node_type(nt), port_type(pt), node1(n1), port1(p1), node2(n2), port2(p2) {}
+			const QString& n2, const QString& p2,
+			qpwgraph_patterns::Syntax sx = qpwgraph_patterns::Exact)
+			: node_type(nt), port_type(pt), node1(n1), port1(p1), node2(n2), port2(p2),
+				syntax(sx), hash(hashOf(nt, pt, node1, port1, node2, port2, sx)) {}
+
+		Item(uint nt, uint pt,
+			const qpwgraph_atom& n1, const qpwgraph_atom& p1,
+			const qpwgraph_atom& n2, const qpwgraph_atom& p2,
+			qpwgraph_patterns::Syntax sx = qpwgraph_patterns::Exact)
+			: node_type(nt), port_type(pt), node1(n1), port1(p1), node2(n2), port2(p2),
+				syntax(sx), hash(hashOf(nt, pt, n1, p1, n2, p2, sx)) {}
 
 		Item(const Item& item) : node_type(item.node_type), port_type(item.port_type),
-			node1(item.node1), port1(item.port1), node2(item.node2), port2(item.port2) {}
+			node1(item.node1), port1(item.port1), node2(item.node2), port2(item.port2),
+			syntax(item.syntax), hash(item.hash) {}
 
 		bool operator== (const Item& item) const
 		{
-			return node_type == item.node_type
+			return hash == item.hash
+				&& node_type == item.node_type
 				&& port_type == item.port_type
+				&& syntax == item.syntax
 				&& node1 == item.node1
 				&& port1 == item.port1
 				&& node2 == item.node2
@@ -106,25 +141,158 @@ public:
 
 		uint node_type;
 		uint port_type;
-		QString node1;
-		QString port1;
-		QString node2;
-		QString port2;
+		qpwgraph_atom node1;
+		qpwgraph_atom port1;
+		qpwgraph_atom node2;
+		qpwgraph_atom port2;
+
+		// Wildcard/regexp pattern rule, when not exact.
+		qpwgraph_patterns::Syntax syntax;
+
+		// Precomputed hash (from the interned name ids).
+		uint hash;
+
+		static uint hashOf(uint nt, uint pt,
+			const qpwgraph_atom& n1, const qpwgraph_atom& p1,
+			const qpwgraph_atom& n2, const qpwgraph_atom& p2,
+			qpwgraph_patterns::Syntax sx)
+		{
+			const quint64 ids[5] = { quint64(sx),
+				quint64(n1.id()), quint64(p1.id()),
+				quint64(n2.id()), quint64(p2.id()) };
+			quint64 h = (quint64(nt) << 32) | pt;
+			for (int i = 0; i < 5; ++i) {
+				h ^= ids[i];
+				h *= Q_UINT64_C(0x9e3779b97f4a7c15);
+				h ^= (h >> 29);
+			}
+			return uint(h ^ (h >> 32));
+		}
 	};
 
-	struct Items : public QHash<Item, Item *>
+	// Patchbay rule items table (flat, open-addressed).
+	//
+	// Each rule is stored only once, in insertion order, and probed
+	// by its precomputed hash; removed rules are left behind as empty
+	// (zero node type) tombstones until the next rehash, so that all
+	// the others stay put in the meantime.
+	//
+	class Items
 	{
+	public:
+
+		// Constructor.
+		Items() : m_count(0), m_used(0) {}
+
+		// Rules management.
 		bool addItem(const Item& item);
 		bool removeItem(const Item& item);
 
 		void copyItems(const Items& items);
 
 		void clearItems();
+
+		// Rules lookup.
+		const Item *findItem(const Item& item) const;
+		const Item *findItem(qpwgraph_port *port1, qpwgraph_port *port2) const;
+
+		bool contains(const Item& item) const
+			{ return (findItem(item) != nullptr); }
+
+		int count() const
+			{ return m_count; }
+		bool isEmpty() const
+			{ return (m_count == 0); }
+
+		// Rules iterator (in insertion order).
+		class ConstIterator
+		{
+		public:
+
+			ConstIterator(const QVector<Item> *items, int index)
+				: m_items(items), m_index(index) { skip(); }
+
+			const Item& key() const
+				{ return m_items->at(m_index); }
+			const Item *value() const
+				{ return &(m_items->at(m_index)); }
+
+			ConstIterator& operator++ ()
+				{ ++m_index; skip(); return *this; }
+
+			bool operator== (const ConstIterator& iter) const
+				{ return m_index == iter.m_index; }
+			bool operator!= (const ConstIterator& iter) const
+				{ return m_index != iter.m_index; }
+
+		private:
+
+			void skip()
+			{
+				const int n = m_items->count();
+				while (m_index < n && m_items->at(m_index).node_type == 0)
+					++m_index;
+			}
+
+			const QVector<Item> *m_items;
+			int m_index;
+		};
+
+		ConstIterator constBegin() const
+			{ return ConstIterator(&m_items, 0); }
+		ConstIterator constEnd() const
+			{ return ConstIterator(&m_items, m_items.count()); }
+
+	protected:
+
+		// Slot probing: the slot holding the rule or else -1.
+		int findSlot(uint hash, uint nt, uint pt,
+			const qpwgraph_atom& n1, const qpwgraph_atom& p1,
+			const qpwgraph_atom& n2, const qpwgraph_atom& p2,
+			qpwgraph_patterns::Syntax sx) const;
+
+		// Resize and compact (drops all tombstones).
+		void rehash(int count);
+
+	private:
+
+		// Hash table slot.
+		struct Slot
+		{
+			uint hash;
+			int  index;		// Rule index (-1=empty, -2=removed).
+		};
+
+		// Instance variables.
+		QVector<Item> m_items;
+		QVector<Slot> m_slots;
+
+		int m_count;		// Live rules.
+		int m_used;			// Non-empty slots (incl. removed).
+	};
+
+	// Compiled rule index key (by endpoint node type and name).
+	//
+	struct NodeKey
+	{
+		NodeKey(uint nt, const qpwgraph_atom& n)
+			: node_type(nt), node(n) {}
+
+		bool operator== (const NodeKey& key) const
+			{ return node_type == key.node_type && node == key.node; }
+
+		uint node_type;
+		qpwgraph_atom node;
 	};
 
+	typedef QMultiHash<NodeKey, const Item *> Index;
+
+	// Whether a connection is covered by any rule.
+	bool matchItem(const Item& item) const;
+
 	// Find a connection rule.
-	Item *findConnectPorts(qpwgraph_port *port1, qpwgraph_port *port2) const;
-	Item *findConnect(qpwgraph_connect *connect) const;
+	const Item *findConnectPorts(qpwgraph_port *port1, qpwgraph_port *port2) const;
+	const Item *findConnect(qpwgraph_connect *connect) const;
 
 	// Patchbay rule items accessors.
 	void setItems(const Items& items);
@@ -144,6 +312,31 @@ protected:
 	static uint portTypeFromText(const QString& text);
 	static const char *textFromPortType(uint port_type);
 
+	// Patchbay rules file I/O, per format (streaming).
+	bool loadXml(QIODevice *device);
+	bool saveXml(QIODevice *device, const QString& name) const;
+
+	bool loadBinary(QIODevice *device);
+	bool saveBinary(QIODevice *device, const QString& name) const;
+
+	// Compiled rule index (re)builder (lazy).
+	void updateIndex() const;
+
+	// Expand the pattern rules matching an output node,
+	// into actual (exact) connection rules.
+	void expandPatterns(qpwgraph_node *node1, QSet<Item>& items) const;
+
+	// Execute and apply only the rules touching the given node keys.
+	bool scanKeys(const QSet<NodeKey>& keys1, const QSet<NodeKey>& keys2);
+
+	// Execute and apply a set of (exact) rules.
+	bool scanItems(const QSet<Item>& items);
+
+	// Execute one rule, collecting the (dis)connections.
+	void scanItem(const Item *item,
+		QHash<Item, qpwgraph_connect *>& disconnects,
+		qpwgraph_port::Pairs& connects) const;
+
 private:
 
 	// Instance variables.
@@ -155,15 +348,33 @@ private:
 	Items m_items;
 
 	int m_dirty;
+
+	// Compiled rule index, by output (1) and input (2) node,
+	// plus the wildcard/regexp pattern rules matcher.
+	mutable Index m_index1;
+	mutable Index m_index2;
+
+	mutable qpwgraph_patterns m_patterns;
+
+	mutable bool m_index_dirty;
+
+	// Pending (changed) output (1) and input (2) nodes.
+	QSet<NodeKey> m_pending1;
+	QSet<NodeKey> m_pending2;
+
+	bool m_pending_all;
 };
 
 
+inline uint qHash ( const qpwgraph_patchbay::NodeKey& key )
+{
+	return qHash(key.node_type) ^ qHash(key.node);
+}
+
+
 inline uint qHash ( const qpwgraph_patchbay::Item& item )
 {
-	return qHash(item.node_type)
-		 ^ qHash(item.port_type)
-		 ^ qHash(item.node1 + item.port1)
-		 ^ qHash(item.node2 + item.port2);
+	return item.hash;
 }
 
 
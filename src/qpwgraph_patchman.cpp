@@ -186,7 +186,7 @@ public:
 protected:
 
 	// Patchbay item connection finder.
-	bool findConnect(qpwgraph_patchbay::Item *item) const;
+	bool findConnect(const qpwgraph_patchbay::Item *item) const;
 
 	// Patchbay connect line finder/removal.
 	bool findLine(
@@ -624,7 +624,7 @@ void qpwgraph_patchman::MainWidget::refresh (void)
 	qpwgraph_patchbay::Items::ConstIterator iter = m_items.constBegin();
 	const qpwgraph_patchbay::Items::ConstIterator& iter_end = m_items.constEnd();
 	for ( ; iter != iter_end; ++iter) {
-		qpwgraph_patchbay::Item *item = iter.value();
+		const qpwgraph_patchbay::Item *item = iter.value();
 		const int data = (findConnect(item) ? 2 : 0);
 		const int node_type = item->node_type;
 		QIcon node_icon;
@@ -1017,8 +1017,8 @@ bool qpwgraph_patchman::MainWidget::canCleanup (void) const
 	qpwgraph_patchbay::Items::ConstIterator iter = m_items.constBegin();
 	const qpwgraph_patchbay::Items::ConstIterator& iter_end = m_items.constEnd();
 	for ( ; iter != iter_end; ++iter) {
-		qpwgraph_patchbay::Item *item = iter.value();
-		if (!findConnect(iter.value()))
+		const qpwgraph_patchbay::Item *item = iter.value();
+		if (item->syntax == qpwgraph_patterns::Exact && !findConnect(item))
 			return true;
 	}
 
@@ -1028,18 +1028,18 @@ bool qpwgraph_patchman::MainWidget::canCleanup (void) const
 
 void qpwgraph_patchman::MainWidget::cleanup (void)
 {
-	QList<qpwgraph_patchbay::Item *> items;
+	QList<const qpwgraph_patchbay::Item *> items;
 
 	qpwgraph_patchbay::Items::ConstIterator iter = m_items.constBegin();
 	const qpwgraph_patchbay::Items::ConstIterator& iter_end = m_items.constEnd();
 	for ( ; iter != iter_end; ++iter) {
-		qpwgraph_patchbay::Item *item = iter.value();
-		if (!findConnect(item))
+		const qpwgraph_patchbay::Item *item = iter.value();
+		if (item->syntax == qpwgraph_patterns::Exact && !findConnect(item))
 			items.append(item);
 	}
 
 	if (!items.isEmpty()) {
-		QListIterator<qpwgraph_patchbay::Item *> iter2(items);
+		QListIterator<const qpwgraph_patchbay::Item *> iter2(items);
 		while (iter2.hasNext())
 			m_items.removeItem(*iter2.next());
 		refresh();
@@ -1049,7 +1049,7 @@ void qpwgraph_patchman::MainWidget::cleanup (void)
 
 // Patchbay item connection finder.
 bool qpwgraph_patchman::MainWidget::findConnect (
-	qpwgraph_patchbay::Item *item ) const
+	const qpwgraph_patchbay::Item *item ) const
 {
 	qpwgraph_patchbay *patchbay = m_patchman->patchbay();
 	if (patchbay == nullptr)
@@ -1160,14 +1160,30 @@ bool qpwgraph_patchman::MainWidget::removeLine (
 
 	m_connects->removeLine(port1_item, port2_item);
 
-	return m_items.removeItem(
-		qpwgraph_patchbay::Item(
-			node1_item->type(),
-			port1_item->type(),
-			node1_item->text(0),
-			port1_item->text(0),
-			node2_item->text(0),
-			port2_item->text(0)));
+	// Either an exact or a wildcard/regexp pattern rule...
+	bool ret = false;
+
+	// Just looking up (never interning) their names...
+	const qpwgraph_atom& node1_name = qpwgraph_atom::lookup(node1_item->text(0));
+	const qpwgraph_atom& port1_name = qpwgraph_atom::lookup(port1_item->text(0));
+	const qpwgraph_atom& node2_name = qpwgraph_atom::lookup(node2_item->text(0));
+	const qpwgraph_atom& port2_name = qpwgraph_atom::lookup(port2_item->text(0));
+
+	for (int i = qpwgraph_patterns::Exact; i <= qpwgraph_patterns::RegExp; ++i) {
+		ret = m_items.removeItem(
+			qpwgraph_patchbay::Item(
+				node1_item->type(),
+				port1_item->type(),
+				node1_name,
+				port1_name,
+				node2_name,
+				port2_name,
+				qpwgraph_patterns::Syntax(i)));
+		if (ret)
+			break;
+	}
+
+	return ret;
 }
 
 
@@ -1179,7 +1195,7 @@ void qpwgraph_patchman::MainWidget::stabilize (void)
 	qpwgraph_patchbay::Items::ConstIterator iter = m_items.constBegin();
 	const qpwgraph_patchbay::Items::ConstIterator& iter_end = m_items.constEnd();
 	for ( ; iter != iter_end; ++iter) {
-		qpwgraph_patchbay::Item *item = iter.value();
+		const qpwgraph_patchbay::Item *item = iter.value();
 		QTreeWidgetItem *node1_item
 			= m_outputs->findNodeItem(item->node1, item->node_type);
 		if (node1_item == nullptr)
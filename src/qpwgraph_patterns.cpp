@@ -0,0 +1,316 @@
+// qpwgraph_patterns.cpp
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qpwgraph_patterns.h"
+
+
+// Maximum number of input side matchers kept in cache.
+#define MAX_REGEXPS_CACHE 1024
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_patterns -- Compiled patchbay pattern rules matcher.
+
+// Rules management; false if invalid.
+bool qpwgraph_patterns::addRule ( uint node_type, uint port_type,
+	Syntax syntax, const QString& node1, const QString& port1,
+	const QString& node2, const QString& port2, const void *data )
+{
+	if (syntax == Exact)
+		return false;
+
+	const QRegularExpression& rx1 = regexp(syntax, node1);
+	const QRegularExpression& rx2 = regexp(syntax, port1);
+	if (!rx1.isValid() || !rx2.isValid())
+		return false;
+
+	Rule *rule = new Rule;
+	rule->node_type = node_type;
+	rule->port_type = port_type;
+	rule->syntax = syntax;
+	rule->node1 = rx1;
+	rule->port1 = rx2;
+	rule->node2 = node2;
+	rule->port2 = port2;
+	rule->data = data;
+
+	rule->node1.optimize();
+	rule->port1.optimize();
+
+	m_rules.append(rule);
+
+	const QString& prefix = literalPrefix(syntax, node1);
+	m_prefixes[prefix].append(rule);
+	if (m_max_prefix < prefix.length())
+		m_max_prefix = prefix.length();
+
+	return true;
+}
+
+
+void qpwgraph_patterns::clear (void)
+{
+	qDeleteAll(m_rules);
+	m_rules.clear();
+
+	m_prefixes.clear();
+	m_max_prefix = 0;
+
+	m_regexps.clear();
+}
+
+
+// Candidate rules for an output node name (literal prefix filter).
+QList<const qpwgraph_patterns::Rule *> qpwgraph_patterns::candidates (
+	uint node_type, const QString& node1 ) const
+{
+	QList<const Rule *> rules;
+
+	const int n = qMin(node1.length(), m_max_prefix);
+	for (int i = 0; i <= n; ++i) {
+		QHash<QString, QList<Rule *> >::ConstIterator iter
+			= m_prefixes.constFind(node1.left(i));
+		if (iter == m_prefixes.constEnd())
+			continue;
+		foreach (const Rule *rule, iter.value()) {
+			if (rule->node_type == node_type)
+				rules.append(rule);
+		}
+	}
+
+	return rules;
+}
+
+
+// Whole rule matching (actual names).
+const qpwgraph_patterns::Rule *qpwgraph_patterns::match (
+	uint node_type, uint port_type,
+	const QString& node1, const QString& port1,
+	const QString& node2, const QString& port2 ) const
+{
+	foreach (const Rule *rule, candidates(node_type, node1)) {
+		if (rule->port_type != port_type)
+			continue;
+		const QRegularExpressionMatch& m1 = rule->node1.match(node1);
+		if (!m1.hasMatch())
+			continue;
+		const QRegularExpressionMatch& m2 = rule->port1.match(port1);
+		if (!m2.hasMatch())
+			continue;
+		if (regexp(rule, rule->node2, m1).match(node2).hasMatch()
+			&& regexp(rule, rule->port2, m2).match(port2).hasMatch())
+			return rule;
+	}
+
+	return nullptr;
+}
+
+
+// Input side matcher, from a template and output side captures.
+QRegularExpression qpwgraph_patterns::regexp ( const Rule *rule,
+	const QString& templ, const QRegularExpressionMatch& captures ) const
+{
+	return regexp(rule->syntax, substitute(rule->syntax, templ, captures));
+}
+
+
+// Compiled (anchored) regular expression (cached).
+QRegularExpression qpwgraph_patterns::regexp (
+	Syntax syntax, const QString& pattern ) const
+{
+	const QString& key = QString::number(int(syntax)) + ':' + pattern;
+
+	QHash<QString, QRegularExpression>::ConstIterator iter
+		= m_regexps.constFind(key);
+	if (iter != m_regexps.constEnd())
+		return iter.value();
+
+	const QString& rx = (syntax == Wildcard
+		? regexpFromWildcard(pattern)
+		: pattern);
+
+	const QRegularExpression regexp("\\A(?:" + rx + ")\\z");
+
+	if (m_regexps.count() >= MAX_REGEXPS_CACHE)
+		m_regexps.clear();
+
+	m_regexps.insert(key, regexp);
+	return regexp;
+}
+
+
+// Wildcard (glob) to regular expression pattern:
+// each * or ? is a capture group, [...] is a character class
+// (negated by a leading !) and a backslash escapes the next.
+QString qpwgraph_patterns::regexpFromWildcard ( const QString& pattern )
+{
+	QString rx;
+
+	const int n = pattern.length();
+	for (int i = 0; i < n; ++i) {
+		const QChar ch = pattern.at(i);
+		if (ch == '*')
+			rx += "(.*)";
+		else
+		if (ch == '?')
+			rx += "(.)";
+		else
+		if (ch == '[') {
+			const int j = pattern.indexOf(']', i + 2);
+			if (j < 0) {
+				rx += "\\[";
+				continue;
+			}
+			QString cls = pattern.mid(i + 1, j - i - 1);
+			if (cls.startsWith('!'))
+				cls[0] = '^';
+			cls.replace("\\", "\\\\");
+			rx += '[' + cls + ']';
+			i = j;
+		}
+		else
+		if (ch == '\\' && i + 1 < n)
+			rx += QRegularExpression::escape(pattern.at(++i));
+		else
+			rx += QRegularExpression::escape(ch);
+	}
+
+	return rx;
+}
+
+
+// Literal (plain text) prefix of a pattern.
+QString qpwgraph_patterns::literalPrefix (
+	Syntax syntax, const QString& pattern )
+{
+	QString prefix;
+
+	const int n = pattern.length();
+
+	if (syntax == Wildcard) {
+		for (int i = 0; i < n; ++i) {
+			const QChar ch = pattern.at(i);
+			if (ch == '*' || ch == '?' || ch == '[')
+				break;
+			if (ch == '\\' && i + 1 < n)
+				prefix += pattern.at(++i);
+			else
+				prefix += ch;
+		}
+		return prefix;
+	}
+
+	// Any alternative makes it all optional...
+	if (pattern.contains('|'))
+		return prefix;
+
+	static const QString s_specials("\\^$.|?*+()[]{}");
+
+	int i = (pattern.startsWith('^') ? 1 : 0);
+	for ( ; i < n; ++i) {
+		const QChar ch = pattern.at(i);
+		if (ch == '\\' && i + 1 < n
+			&& !pattern.at(i + 1).isLetterOrNumber()) {
+			prefix += pattern.at(++i);
+			continue;
+		}
+		if (s_specials.contains(ch)) {
+			// Last literal might be optional or repeated...
+			if ((ch == '?' || ch == '*' || ch == '{') && !prefix.isEmpty())
+				prefix.chop(1);
+			break;
+		}
+		prefix += ch;
+	}
+
+	return prefix;
+}
+
+
+// Template substitution of \1..\9 by the respective captures
+// (escaped, so that they match literally); \\ is a backslash.
+QString qpwgraph_patterns::substitute ( Syntax syntax,
+	const QString& templ, const QRegularExpressionMatch& captures )
+{
+	if (!templ.contains('\\'))
+		return templ;
+
+	static const QString s_wildcard_specials("\\*?[");
+
+	QString text;
+
+	const int n = templ.length();
+	for (int i = 0; i < n; ++i) {
+		const QChar ch = templ.at(i);
+		if (ch == '\\' && i + 1 < n) {
+			const QChar ch2 = templ.at(i + 1);
+			if (ch2 >= '1' && ch2 <= '9') {
+				const QString& cap = captures.captured(ch2.digitValue());
+				if (syntax == Wildcard) {
+					foreach (const QChar& ch3, cap) {
+						if (s_wildcard_specials.contains(ch3))
+							text += '\\';
+						text += ch3;
+					}
+				} else {
+					text += QRegularExpression::escape(cap);
+				}
+				++i;
+				continue;
+			}
+			text += ch;
+			text += ch2;
+			++i;
+			continue;
+		}
+		text += ch;
+	}
+
+	return text;
+}
+
+
+// Pattern syntax to/from text helpers.
+qpwgraph_patterns::Syntax qpwgraph_patterns::syntaxFromText ( const QString& text )
+{
+	if (text == "wildcard")
+		return Wildcard;
+	else
+	if (text == "regexp")
+		return RegExp;
+	else
+		return Exact;
+}
+
+
+const char *qpwgraph_patterns::textFromSyntax ( Syntax syntax )
+{
+	if (syntax == Wildcard)
+		return "wildcard";
+	else
+	if (syntax == RegExp)
+		return "regexp";
+	else
+	return nullptr;
+}
+
+
+// end of qpwgraph_patterns.cpp
@@ -0,0 +1,129 @@
+// qpwgraph_patterns.h
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qpwgraph_patterns_h
+#define __qpwgraph_patterns_h
+
+#include <QString>
+#include <QList>
+#include <QHash>
+
+#include <QRegularExpression>
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_patterns -- Compiled patchbay pattern rules matcher.
+//
+// Wildcard (glob) or regular expression rules, matching node and port
+// names: output side patterns are compiled once; input side ones are
+// templates, where \1..\9 get substituted by the respective output node
+// (or port) captures before matching. Rules are filed by the literal
+// prefix of their output node pattern, so that only the few rules that
+// might possibly match a given node name are ever tried.
+//
+
+class qpwgraph_patterns
+{
+public:
+
+	// Pattern syntaxes.
+	enum Syntax { Exact = 0, Wildcard, RegExp };
+
+	// Compiled pattern rule.
+	struct Rule
+	{
+		uint    node_type;
+		uint    port_type;
+		Syntax  syntax;
+
+		QRegularExpression node1;	// Output side (compiled).
+		QRegularExpression port1;
+
+		QString node2;				// Input side (templates).
+		QString port2;
+
+		const void *data;			// Opaque (owner rule item).
+	};
+
+	// Constructor.
+	qpwgraph_patterns() : m_max_prefix(0) {}
+
+	// Destructor.
+	~qpwgraph_patterns() { clear(); }
+
+	// Rules management; false if invalid.
+	bool addRule(uint node_type, uint port_type, Syntax syntax,
+		const QString& node1, const QString& port1,
+		const QString& node2, const QString& port2, const void *data = nullptr);
+
+	void clear();
+
+	int count() const
+		{ return m_rules.count(); }
+	bool isEmpty() const
+		{ return m_rules.isEmpty(); }
+
+	// Candidate rules for an output node name (literal prefix filter).
+	QList<const Rule *> candidates(uint node_type, const QString& node1) const;
+
+	// Whole rule matching (actual names).
+	const Rule *match(uint node_type, uint port_type,
+		const QString& node1, const QString& port1,
+		const QString& node2, const QString& port2) const;
+
+	// Input side matcher, from a template and output side captures.
+	QRegularExpression regexp(const Rule *rule, const QString& templ,
+		const QRegularExpressionMatch& captures) const;
+
+	// Pattern syntax to/from text helpers.
+	static Syntax syntaxFromText(const QString& text);
+	static const char *textFromSyntax(Syntax syntax);
+
+protected:
+
+	// Compiled (anchored) regular expression (cached).
+	QRegularExpression regexp(Syntax syntax, const QString& pattern) const;
+
+	// Pattern helpers.
+	static QString regexpFromWildcard(const QString& pattern);
+	static QString literalPrefix(Syntax syntax, const QString& pattern);
+	static QString substitute(Syntax syntax, const QString& templ,
+		const QRegularExpressionMatch& captures);
+
+private:
+
+	// Not copyable.
+	qpwgraph_patterns(const qpwgraph_patterns&) = delete;
+	qpwgraph_patterns& operator= (const qpwgraph_patterns&) = delete;
+
+	// Instance variables.
+	QList<Rule *> m_rules;
+
+	QHash<QString, QList<Rule *> > m_prefixes;
+	int m_max_prefix;
+
+	mutable QHash<QString, QRegularExpression> m_regexps;
+};
+
+
+#endif	// __qpwgraph_patterns_h
+
+// end of qpwgraph_patterns.h
@@ -31,6 +31,14 @@
 #include <QTimer>
 
 
+// Change journal maximum length (changed nodes),
+// before a full inventory gets due.
+#define MAX_CHANGES 1024
+
+// Event queue capacity (PipeWire thread-loop to GUI thread).
+#define MAX_EVENTS 8192
+
+
 // Default port types...
 #define DEFAULT_AUDIO_TYPE "32 bit float mono audio"
 #define DEFAULT_MIDI_TYPE  "8 bit raw midi"
@@ -68,6 +76,8 @@ struct qpwgraph_pipewire::Proxy
 {
 	qpwgraph_pipewire *pw;
 	struct pw_proxy *proxy;
+	uint id;
+	uint type;
 	void *info;
 	pw_destroy_t destroy;
 	struct spa_hook proxy_listener;
@@ -80,17 +90,15 @@ struct qpwgraph_pipewire::Object
 {
 	enum Type { Node, Port, Link };
 
-	Object(uint oid, Type otype) : id(oid), type(otype), p(nullptr) {}
+	Object(uint oid, Type otype)
+		: id(oid), type(otype), object_item(this) {}
 
-	virtual ~Object() { destroy_proxy(); }
-
-	void create_proxy(qpwgraph_pipewire *pw);
-	void destroy_proxy ();
+	virtual ~Object() {}
 
 	uint id;
 	Type type;
 
-	Proxy *p;
+	qpwgraph_list<Object>::Item object_item;
 };
 
 struct qpwgraph_pipewire::Node : public qpwgraph_pipewire::Object
@@ -104,6 +112,12 @@ struct qpwgraph_pipewire::Node : public qpwgraph_pipewire::Object
 		Midi  = 4
 	};
 
+	enum ClientApi {
+		Native = 0,
+		Jack   = 1,
+		Pulse  = 2
+	};
+
 	struct NameKey
 	{
 		NameKey (Node *node)
@@ -123,16 +137,16 @@ struct qpwgraph_pipewire::Node : public qpwgraph_pipewire::Object
 				&& node_name == key.node_name;
 		}
 
-		QString node_name;
+		qpwgraph_atom node_name;
 		qpwgraph_item::Mode node_mode;
 		uint node_type;
 	};
 
-	QString node_name;
-	QString node_nick;
+	qpwgraph_atom node_name;
+	qpwgraph_atom node_nick;
 	qpwgraph_item::Mode node_mode;
 	NodeType node_type;
-	QList<qpwgraph_pipewire::Port *> node_ports;
+	qpwgraph_list<qpwgraph_pipewire::Port> node_ports;
 	qpwgraph_item::Mode node_mode2;
 	QIcon node_icon;
 	QString media_name;
@@ -143,7 +157,7 @@ struct qpwgraph_pipewire::Node : public qpwgraph_pipewire::Object
 
 struct qpwgraph_pipewire::Port : public qpwgraph_pipewire::Object
 {
-	Port (uint port_id) : Object(port_id, Type::Port) {}
+	Port (uint port_id) : Object(port_id, Type::Port), node_item(this) {}
 
 	enum Flags {
 		None     = 0,
@@ -154,19 +168,44 @@ struct qpwgraph_pipewire::Port : public qpwgraph_pipewire::Object
 	};
 
 	uint node_id;
-	QString port_name;
+	qpwgraph_atom port_name;
 	qpwgraph_item::Mode port_mode;
 	uint port_type;
 	Flags port_flags;
-	QList<qpwgraph_pipewire::Link *> port_links;
+	qpwgraph_list<qpwgraph_pipewire::Link> port_links;
+
+	qpwgraph_list<qpwgraph_pipewire::Port>::Item node_item;
 };
 
 struct qpwgraph_pipewire::Link : public qpwgraph_pipewire::Object
 {
-	Link (uint link_id) : Object(link_id, Type::Link) {}
+	Link (uint link_id) : Object(link_id, Type::Link),
+		port1_item(this), port2_item(this) {}
+
+	uint port1_id;
+	uint port2_id;
+
+	qpwgraph_list<qpwgraph_pipewire::Link>::Item port1_item;
+	qpwgraph_list<qpwgraph_pipewire::Link>::Item port2_item;
+};
+
+// Compact (POD) event record, as parsed on the PipeWire thread-loop
+// and queued to the GUI thread, where the object database lives.
+struct qpwgraph_pipewire::Event
+{
+	enum Type { NodeAdded, NodeInfo, PortAdded, LinkAdded, Removed, CoreInfo, Synced };
 
+	Type type;
+	uint id;
+	uint node_id;
 	uint port1_id;
 	uint port2_id;
+	qpwgraph_item::Mode mode;
+	uint node_types;
+	uint client_api;
+	uint port_type;
+	uint port_flags;
+	char *strs[2];
 };
 
 struct qpwgraph_pipewire::Data
@@ -186,6 +225,18 @@ struct qpwgraph_pipewire::Data
 	int last_res;
 	bool error;
 
+	int sync_phase;
+	int sync_seq;
+
+	struct spa_list link_requests;
+
+	typedef QHash<uint, Proxy *> Proxies;
+
+	Proxies *proxies;
+
+	uint proxies_bound;
+	uint proxies_deferred;
+
 	typedef QMultiHash<Node::NameKey, uint> NodeNames;
 
 	NodeNames *node_names;
@@ -197,6 +248,149 @@ inline uint qHash ( const qpwgraph_pipewire::Node::NameKey& key )
 }
 
 
+// event-methods...
+static
+char *qpwgraph_event_strdup ( const char *str )
+{
+	return (str && ::strlen(str) > 0 ? ::strdup(str) : nullptr);
+}
+
+static
+void qpwgraph_event_free ( qpwgraph_pipewire::Event& event )
+{
+	for (char *& str : event.strs) {
+		if (str) {
+			::free(str);
+			str = nullptr;
+		}
+	}
+}
+// event-methods.
+
+
+// class-tables...
+static constexpr
+uint qpwgraph_class_hash ( const char *str )
+{
+	// FNV-1a (32 bit)...
+	uint hash = 2166136261u;
+	while (*str)
+		hash = (hash ^ uint(uchar(*str++))) * 16777619u;
+	return hash;
+}
+
+struct qpwgraph_class_item
+{
+	constexpr qpwgraph_class_item (
+		const char *str, qpwgraph_item::Mode m, uint f )
+		: name(str), hash(qpwgraph_class_hash(str)), mode(m), flags(f) {}
+
+	const char *name;
+	uint hash;
+	qpwgraph_item::Mode mode;
+	uint flags;
+};
+
+template <int N>
+static constexpr
+bool qpwgraph_class_perfect ( const qpwgraph_class_item (&items)[N] )
+{
+	for (int i = 0; i < N; ++i) {
+		for (int j = i + 1; j < N; ++j) {
+			if (items[i].hash == items[j].hash)
+				return false;
+		}
+	}
+	return true;
+}
+
+template <int N>
+static
+const qpwgraph_class_item *qpwgraph_class_find (
+	const qpwgraph_class_item (&items)[N], const char *str )
+{
+	const uint hash = qpwgraph_class_hash(str);
+	for (const qpwgraph_class_item& item : items) {
+		if (item.hash == hash && ::strcmp(item.name, str) == 0)
+			return &item;
+	}
+	return nullptr;
+}
+
+// Well-known media classes: node mode and types.
+static constexpr
+qpwgraph_class_item qpwgraph_media_classes[] = {
+	{ "Audio/Sink",           qpwgraph_item::Input,  qpwgraph_pipewire::Node::Audio },
+	{ "Audio/Sink/Virtual",   qpwgraph_item::Input,  qpwgraph_pipewire::Node::Audio },
+	{ "Audio/Source",         qpwgraph_item::Output, qpwgraph_pipewire::Node::Audio },
+	{ "Audio/Source/Virtual", qpwgraph_item::Output, qpwgraph_pipewire::Node::Audio },
+	{ "Audio/Duplex",         qpwgraph_item::None,   qpwgraph_pipewire::Node::Audio },
+	{ "Stream/Input/Audio",   qpwgraph_item::Input,  qpwgraph_pipewire::Node::Audio },
+	{ "Stream/Output/Audio",  qpwgraph_item::Output, qpwgraph_pipewire::Node::Audio },
+	{ "Video/Sink",           qpwgraph_item::Input,  qpwgraph_pipewire::Node::Video },
+	{ "Video/Source",         qpwgraph_item::Output, qpwgraph_pipewire::Node::Video },
+	{ "Video/Source/Virtual", qpwgraph_item::Output, qpwgraph_pipewire::Node::Video },
+	{ "Video/Duplex",         qpwgraph_item::None,   qpwgraph_pipewire::Node::Video },
+	{ "Stream/Input/Video",   qpwgraph_item::Input,  qpwgraph_pipewire::Node::Video },
+	{ "Stream/Output/Video",  qpwgraph_item::Output, qpwgraph_pipewire::Node::Video },
+	{ "Midi/Sink",            qpwgraph_item::Input,  qpwgraph_pipewire::Node::Midi  },
+	{ "Midi/Source",          qpwgraph_item::Output, qpwgraph_pipewire::Node::Midi  },
+	{ "Midi/Bridge",          qpwgraph_item::None,   qpwgraph_pipewire::Node::Midi  }
+};
+
+static_assert(qpwgraph_class_perfect(qpwgraph_media_classes),
+	"qpwgraph_media_classes: hash collision.");
+
+// Well-known client APIs.
+static constexpr
+qpwgraph_class_item qpwgraph_client_apis[] = {
+	{ "jack",           qpwgraph_item::None, qpwgraph_pipewire::Node::Jack  },
+	{ "pipewire-jack",  qpwgraph_item::None, qpwgraph_pipewire::Node::Jack  },
+	{ "pulse",          qpwgraph_item::None, qpwgraph_pipewire::Node::Pulse },
+	{ "pipewire-pulse", qpwgraph_item::None, qpwgraph_pipewire::Node::Pulse }
+};
+
+static_assert(qpwgraph_class_perfect(qpwgraph_client_apis),
+	"qpwgraph_client_apis: hash collision.");
+
+// Media class classifier (node mode and types).
+static
+void qpwgraph_media_class ( const char *str,
+	qpwgraph_item::Mode& node_mode, uint& node_types )
+{
+	const qpwgraph_class_item *item
+		= qpwgraph_class_find(qpwgraph_media_classes, str);
+	if (item) {
+		node_mode = item->mode;
+		node_types = item->flags;
+		return;
+	}
+
+	// Fallback parsing, for the unknown ones...
+	if (::strstr(str, "Source") || ::strstr(str, "Output"))
+		node_mode = qpwgraph_item::Output;
+	else
+	if (::strstr(str, "Sink") || ::strstr(str, "Input"))
+		node_mode = qpwgraph_item::Input;
+	if (::strstr(str, "Audio"))
+		node_types |= qpwgraph_pipewire::Node::Audio;
+	if (::strstr(str, "Video"))
+		node_types |= qpwgraph_pipewire::Node::Video;
+	if (::strstr(str, "Midi"))
+		node_types |= qpwgraph_pipewire::Node::Midi;
+}
+
+// Client API classifier.
+static
+uint qpwgraph_client_api ( const char *str )
+{
+	const qpwgraph_class_item *item
+		= qpwgraph_class_find(qpwgraph_client_apis, str);
+	return (item ? item->flags : qpwgraph_pipewire::Node::Native);
+}
+// class-tables.
+
+
 // sync-methods...
 static
 void qpwgraph_add_pending ( qpwgraph_pipewire::Proxy *p )
@@ -224,49 +418,26 @@ void qpwgraph_remove_pending ( qpwgraph_pipewire::Proxy *p )
 static
 void qpwgraph_node_event_info ( void *data, const struct pw_node_info *info )
 {
-	qpwgraph_pipewire::Object *object
-		= static_cast<qpwgraph_pipewire::Object *> (data);
-	if (object && object->p) {
-		info = pw_node_info_update((struct pw_node_info *)object->p->info, info);
-		object->p->info = (void *)info;
+	qpwgraph_pipewire::Proxy *p
+		= static_cast<qpwgraph_pipewire::Proxy *> (data);
+	if (p) {
+		info = pw_node_info_update((struct pw_node_info *)p->info, info);
+		p->info = (void *)info;
 		// Get node icon and media.name, if any...
 		if (info && (info->change_mask & PW_NODE_CHANGE_MASK_PROPS)) {
-			qpwgraph_pipewire::Node *node
-				= static_cast<qpwgraph_pipewire::Node *> (object);
-			if (node) {
-				QIcon node_icon;
-				const char *icon_name
-					= spa_dict_lookup(info->props, PW_KEY_APP_ICON_NAME);
-				if (icon_name && ::strlen(icon_name) > 0)
-					node_icon = qpwgraph_icon(icon_name);
-				if (node_icon.isNull())
-					node_icon = qpwgraph_icon(node->node_name.toLower());
-				if (node_icon.isNull()) {
-					const char *client_api
-						= spa_dict_lookup(info->props, PW_KEY_CLIENT_API);
-					if (client_api && ::strlen(client_api) > 0) {
-						if (::strcmp(client_api, "jack") == 0 ||
-							::strcmp(client_api, "pipewire-jack") == 0) {
-							node_icon = qpwgraph_icon(":images/itemJack.png");
-						}
-						else
-						if (::strcmp(client_api, "pulse") == 0 ||
-							::strcmp(client_api, "pipewire-pulse") == 0) {
-							node_icon = qpwgraph_icon(":images/itemPulse.png");
-						}
-					}
-				}
-				if (!node_icon.isNull())
-					node->node_icon = node_icon;
-				const char *media_name
-					= spa_dict_lookup(info->props, PW_KEY_MEDIA_NAME);
-				if (media_name && ::strlen(media_name) > 0)
-					node->media_name = media_name;
-				node->node_changed = true;
-				node->node_ready = true;
-				if (object->p->pw)
-					object->p->pw->changedNotify();
-			}
+			qpwgraph_pipewire::Event event;
+			spa_zero(event);
+			event.type = qpwgraph_pipewire::Event::NodeInfo;
+			event.id = p->id;
+			event.strs[0] = qpwgraph_event_strdup(
+				spa_dict_lookup(info->props, PW_KEY_APP_ICON_NAME));
+			event.strs[1] = qpwgraph_event_strdup(
+				spa_dict_lookup(info->props, PW_KEY_MEDIA_NAME));
+			const char *client_api
+				= spa_dict_lookup(info->props, PW_KEY_CLIENT_API);
+			if (client_api)
+				event.client_api = qpwgraph_client_api(client_api);
+			p->pw->pushEvent(event);
 		}
 	}
 }
@@ -283,11 +454,11 @@ const struct pw_node_events qpwgraph_node_events = {
 static
 void qpwgraph_port_event_info ( void *data, const struct pw_port_info *info )
 {
-	qpwgraph_pipewire::Object *object
-		= static_cast<qpwgraph_pipewire::Object *> (data);
-	if (object && object->p) {
-		info = pw_port_info_update((struct pw_port_info *)object->p->info, info);
-		object->p->info = (void *)info;
+	qpwgraph_pipewire::Proxy *p
+		= static_cast<qpwgraph_pipewire::Proxy *> (data);
+	if (p) {
+		info = pw_port_info_update((struct pw_port_info *)p->info, info);
+		p->info = (void *)info;
 	}
 }
 
@@ -303,11 +474,11 @@ const struct pw_port_events qpwgraph_port_events = {
 static
 void qpwgraph_link_event_info ( void *data, const struct pw_link_info *info )
 {
-	qpwgraph_pipewire::Object *object
-		= static_cast<qpwgraph_pipewire::Object *> (data);
-	if (object && object->p) {
-		info = pw_link_info_update((struct pw_link_info *)object->p->info, info);
-		object->p->info = (void *)info;
+	qpwgraph_pipewire::Proxy *p
+		= static_cast<qpwgraph_pipewire::Proxy *> (data);
+	if (p) {
+		info = pw_link_info_update((struct pw_link_info *)p->info, info);
+		p->info = (void *)info;
 	}
 }
 
@@ -319,15 +490,39 @@ const struct pw_link_events qpwgraph_link_events = {
 // link-events.
 
 
-// proxy-events...
+// proxy-methods (PipeWire thread-loop only)...
+static
+void qpwgraph_proxy_free ( qpwgraph_pipewire::Proxy *p )
+{
+	spa_hook_remove(&p->object_listener);
+	spa_hook_remove(&p->proxy_listener);
+
+	qpwgraph_remove_pending(p);
+
+	if (p->info && p->destroy) {
+		p->destroy(p->info);
+		p->info = nullptr;
+	}
+
+	qpwgraph_pipewire::Data *pd = p->pw->data();
+	if (pd && pd->proxies)
+		pd->proxies->remove(p->id);
+
+	// Proxy user data (p) is gone after this...
+	struct pw_proxy *proxy = p->proxy;
+	p->proxy = nullptr;
+	if (proxy)
+		pw_proxy_destroy(proxy);
+}
+
 static void
 qpwgraph_proxy_removed ( void *data )
 {
-	qpwgraph_pipewire::Object *object
-		= static_cast<qpwgraph_pipewire::Object *> (data);
-	if (object && object->p && object->p->proxy) {
-		struct pw_proxy *proxy = object->p->proxy;
-		object->p->proxy = nullptr;
+	qpwgraph_pipewire::Proxy *p
+		= static_cast<qpwgraph_pipewire::Proxy *> (data);
+	if (p && p->proxy) {
+		struct pw_proxy *proxy = p->proxy;
+		p->proxy = nullptr;
 		pw_proxy_destroy(proxy);
 	}
 }
@@ -335,10 +530,10 @@ qpwgraph_proxy_removed ( void *data )
 static void
 qpwgraph_proxy_destroy ( void *data )
 {
-	qpwgraph_pipewire::Object *object
-		= static_cast<qpwgraph_pipewire::Object *> (data);
-	if (object)
-		object->destroy_proxy();
+	qpwgraph_pipewire::Proxy *p
+		= static_cast<qpwgraph_pipewire::Proxy *> (data);
+	if (p)
+		qpwgraph_proxy_free(p);
 }
 
 static
@@ -347,12 +542,16 @@ const struct pw_proxy_events qpwgraph_proxy_events = {
 	.destroy = qpwgraph_proxy_destroy,
 	.removed = qpwgraph_proxy_removed,
 };
-// proxy-events.
 
-// proxy-methods...
-void qpwgraph_pipewire::Object::create_proxy ( qpwgraph_pipewire *pw )
+static
+qpwgraph_pipewire::Proxy *qpwgraph_proxy_bind (
+	qpwgraph_pipewire *pw, uint id, qpwgraph_pipewire::Object::Type type )
 {
-	if (p) return;
+	qpwgraph_pipewire::Data *pd = pw->data();
+
+	qpwgraph_pipewire::Proxy *p = pd->proxies->value(id, nullptr);
+	if (p)
+		return p;
 
 	const char *proxy_type = nullptr;
 	uint32_t version = 0;
@@ -360,19 +559,19 @@ void qpwgraph_pipewire::Object::create_proxy ( qpwgraph_pipewire *pw )
 	const void *events = nullptr;
 
 	switch (type) {
-	case Node:
+	case qpwgraph_pipewire::Object::Node:
 		proxy_type = PW_TYPE_INTERFACE_Node;
 		version = PW_VERSION_NODE;
 		destroy = (pw_destroy_t) pw_node_info_free;
 		events = &qpwgraph_node_events;
 		break;
-	case Port:
+	case qpwgraph_pipewire::Object::Port:
 		proxy_type = PW_TYPE_INTERFACE_Port;
 		version = PW_VERSION_PORT;
 		destroy = (pw_destroy_t) pw_port_info_free;
 		events = &qpwgraph_port_events;
 		break;
-	case Link:
+	case qpwgraph_pipewire::Object::Link:
 		proxy_type = PW_TYPE_INTERFACE_Link;
 		version = PW_VERSION_LINK;
 		destroy = (pw_destroy_t) pw_link_info_free;
@@ -381,42 +580,39 @@ void qpwgraph_pipewire::Object::create_proxy ( qpwgraph_pipewire *pw )
 	}
 
 	struct pw_proxy *proxy = (struct pw_proxy *)pw_registry_bind(
-		pw->data()->registry, id, proxy_type, version, sizeof(Proxy));
+		pd->registry, id, proxy_type, version, sizeof(qpwgraph_pipewire::Proxy));
 	if (proxy)
-		p = (Proxy *)pw_proxy_get_user_data(proxy);
+		p = (qpwgraph_pipewire::Proxy *)pw_proxy_get_user_data(proxy);
 	if (p) {
 		p->pw = pw;
 		p->proxy = proxy;
+		p->id = id;
+		p->type = type;
+		p->info = nullptr;
 		p->destroy = destroy;
 		p->pending_seq = 0;
 		pw_proxy_add_object_listener(proxy,
-			&p->object_listener, events, this);
+			&p->object_listener, events, p);
 		pw_proxy_add_listener(proxy,
-			&p->proxy_listener, &qpwgraph_proxy_events, this);
+			&p->proxy_listener, &qpwgraph_proxy_events, p);
+		pd->proxies->insert(id, p);
+		++pd->proxies_bound;
 	}
+
+	return p;
 }
 
-void qpwgraph_pipewire::Object::destroy_proxy (void)
+static
+void qpwgraph_proxies_clear ( qpwgraph_pipewire *pw )
 {
-	if (p == nullptr)
-		return;
-
-	spa_hook_remove(&p->object_listener);
-	spa_hook_remove(&p->proxy_listener);
-
-	qpwgraph_remove_pending(p);
-
-	if (p->info && p->destroy) {
-		p->destroy(p->info);
-		p->info = nullptr;
-	}
+	qpwgraph_pipewire::Data *pd = pw->data();
 
-	if (p->proxy) {
-		pw_proxy_destroy(p->proxy);
-		p->proxy = nullptr;
-	}
+	const QList<qpwgraph_pipewire::Proxy *> proxies
+		= pd->proxies->values();
+	foreach (qpwgraph_pipewire::Proxy *p, proxies)
+		qpwgraph_proxy_free(p);
 
-	p = nullptr;
+	pd->proxies->clear();
 }
 // proxy-methods.
 
@@ -439,10 +635,12 @@ void qpwgraph_registry_event_global (
 	qDebug("qpwgraph_registry_event_global[%p]: id:%u type:%s/%u", pw, id, type, version);
 #endif
 
-	int nchanged = 0;
+	qpwgraph_pipewire::Event event;
+	spa_zero(event);
+	event.id = id;
 
 	if (::strcmp(type, PW_TYPE_INTERFACE_Node) == 0) {
-		QString node_name;
+		QByteArray node_name;
 		const char *str = spa_dict_lookup(props, PW_KEY_NODE_DESCRIPTION);
 		const char *nick = spa_dict_lookup(props, PW_KEY_NODE_NICK);
 		if (str == nullptr || ::strlen(str) < 1)
@@ -457,56 +655,39 @@ void qpwgraph_registry_event_global (
 			node_name += '/';
 		}
 		node_name += str;
-		const QString node_nick(nick ? nick : str);
+		event.strs[0] = qpwgraph_event_strdup(node_name.constData());
+		event.strs[1] = qpwgraph_event_strdup(nick ? nick : str);
 		qpwgraph_item::Mode node_mode = qpwgraph_item::None;
 		uint node_types = qpwgraph_pipewire::Node::None;
 		str = spa_dict_lookup(props, PW_KEY_MEDIA_CLASS);
-		if (str) {
-			const QString media_class(str);
-			if (media_class.contains("Source") ||
-				media_class.contains("Output"))
-				node_mode = qpwgraph_item::Output;
-			else
-			if (media_class.contains("Sink") ||
-				media_class.contains("Input"))
-				node_mode = qpwgraph_item::Input;
-			if (media_class.contains("Audio"))
-				node_types |= qpwgraph_pipewire::Node::Audio;
-			if (media_class.contains("Video"))
-				node_types |= qpwgraph_pipewire::Node::Video;
-			if (media_class.contains("Midi"))
-				node_types |= qpwgraph_pipewire::Node::Midi;
-		}
+		if (str)
+			qpwgraph_media_class(str, node_mode, node_types);
 		if (node_mode == qpwgraph_item::None) {
 			str = spa_dict_lookup(props, PW_KEY_MEDIA_CATEGORY);
-			if (str) {
-				const QString media_category(str);
-				if (media_category.contains("Duplex"))
-					node_mode = qpwgraph_item::Duplex;
-			}
+			if (str && ::strstr(str, "Duplex"))
+				node_mode = qpwgraph_item::Duplex;
 		}
-		if (pw->createNode(id, node_name, node_nick, node_mode, node_types))
-			++nchanged;
+		event.type = qpwgraph_pipewire::Event::NodeAdded;
+		event.mode = node_mode;
+		event.node_types = node_types;
+		pw->pushEvent(event);
+		qpwgraph_proxy_bind(pw, id, qpwgraph_pipewire::Object::Node);
 	}
 	else
 	if (::strcmp(type, PW_TYPE_INTERFACE_Port) == 0) {
 		const char *str = spa_dict_lookup(props, PW_KEY_NODE_ID);
 		const uint node_id = (str ? uint(::atoi(str)) : 0);
-		QString port_name;
 		str = spa_dict_lookup(props, PW_KEY_PORT_ALIAS);
 		if (str == nullptr)
 			str = spa_dict_lookup(props, PW_KEY_PORT_NAME);
 		if (str == nullptr)
 			str = "port";
-		port_name += str;
-		qpwgraph_pipewire::Node *n = pw->findNode(node_id);
-		uint port_type = qpwgraph_pipewire::otherPortType();
+		event.strs[0] = qpwgraph_event_strdup(str);
+		// Otherwise inferred from its node, on the other side...
+		uint port_type = 0;
 		str = spa_dict_lookup(props, PW_KEY_FORMAT_DSP);
 		if (str)
 			port_type = qpwgraph_item::itemType(str);
-		else
-		if (n && n->node_type == qpwgraph_pipewire::Node::Video)
-			port_type = qpwgraph_pipewire::videoPortType();
 		qpwgraph_item::Mode port_mode = qpwgraph_item::None;
 		str = spa_dict_lookup(props, PW_KEY_PORT_DIRECTION);
 		if (str) {
@@ -517,8 +698,6 @@ void qpwgraph_registry_event_global (
 				port_mode = qpwgraph_item::Output;
 		}
 		uint port_flags = qpwgraph_pipewire::Port::None;
-		if (n && (n->node_mode != qpwgraph_item::Duplex))
-			port_flags |= qpwgraph_pipewire::Port::Terminal;
 		str = spa_dict_lookup(props, PW_KEY_PORT_PHYSICAL);
 		if (str && pw_properties_parse_bool(str))
 			port_flags |= qpwgraph_pipewire::Port::Physical;
@@ -531,8 +710,14 @@ void qpwgraph_registry_event_global (
 		str = spa_dict_lookup(props, PW_KEY_PORT_CONTROL);
 		if (str && pw_properties_parse_bool(str))
 			port_flags |= qpwgraph_pipewire::Port::Control;
-		if (pw->createPort(id, node_id, port_name, port_mode, port_type, port_flags))
-			++nchanged;
+		event.type = qpwgraph_pipewire::Event::PortAdded;
+		event.node_id = node_id;
+		event.mode = port_mode;
+		event.port_type = port_type;
+		event.port_flags = port_flags;
+		pw->pushEvent(event);
+		// Port proxies are never bound (their info is never read)...
+		++pw->data()->proxies_deferred;
 	}
 	else
 	if (::strcmp(type, PW_TYPE_INTERFACE_Link) == 0) {
@@ -540,24 +725,33 @@ void qpwgraph_registry_event_global (
 		const uint port1_id = (str ? uint(pw_properties_parse_int(str)) : 0);
 		str = spa_dict_lookup(props, PW_KEY_LINK_INPUT_PORT);
 		const uint port2_id = (str ? uint(pw_properties_parse_int(str)) : 0);
-		if (pw->createLink(id, port1_id, port2_id))
-			++nchanged;
+		event.type = qpwgraph_pipewire::Event::LinkAdded;
+		event.port1_id = port1_id;
+		event.port2_id = port2_id;
+		pw->pushEvent(event);
+		// Link proxies are never bound (their info is never read)...
+		++pw->data()->proxies_deferred;
 	}
-
-	if (nchanged > 0)
-		pw->changedNotify();
 }
 
 static
 void qpwgraph_registry_event_global_remove ( void *data, uint32_t id )
 {
 	qpwgraph_pipewire *pw = static_cast<qpwgraph_pipewire *> (data);
+	qpwgraph_pipewire::Data *pd = pw->data();
 #ifdef CONFIG_DEBUG
 	qDebug("qpwgraph_registry_event_global_remove[%p]: id:%u", pw, id);
 #endif
 
-	pw->removeObjectEx(id);
-	pw->changedNotify();
+	qpwgraph_pipewire::Proxy *p = pd->proxies->value(id, nullptr);
+	if (p)
+		qpwgraph_proxy_free(p);
+
+	qpwgraph_pipewire::Event event;
+	spa_zero(event);
+	event.type = qpwgraph_pipewire::Event::Removed;
+	event.id = id;
+	pw->pushEvent(event);
 }
 
 static
@@ -569,6 +763,78 @@ const struct pw_registry_events qpwgraph_registry_events = {
 // registry-events.
 
 
+// link-requests...
+struct qpwgraph_link_request
+{
+	struct pw_proxy *proxy;
+	struct spa_hook listener;
+	uint port1_id;
+	uint port2_id;
+	bool is_connect;
+	int res;
+	int seq;
+	struct spa_list link;
+};
+
+static
+void qpwgraph_link_proxy_error ( void *data, int seq, int res, const char *message )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qpwgraph_link_proxy_error: seq:%d res:%d : %s", seq, res, message);
+#endif
+
+	qpwgraph_link_request *req = static_cast<qpwgraph_link_request *> (data);
+	if (req)
+		req->res = res;
+}
+
+static
+const struct pw_proxy_events qpwgraph_link_proxy_events = {
+	.version = PW_VERSION_PROXY_EVENTS,
+	.error = qpwgraph_link_proxy_error,
+};
+
+static
+void qpwgraph_link_request_free ( qpwgraph_link_request *req )
+{
+	spa_list_remove(&req->link);
+
+	if (req->proxy) {
+		spa_hook_remove(&req->listener);
+		pw_proxy_destroy(req->proxy);
+		req->proxy = nullptr;
+	}
+
+	delete req;
+}
+
+static
+void qpwgraph_link_requests_done ( qpwgraph_pipewire *pw, int seq )
+{
+	qpwgraph_pipewire::Data *pd = pw->data();
+
+	qpwgraph_link_request *req, *tmp;
+	spa_list_for_each_safe(req, tmp, &pd->link_requests, link) {
+		if (req->seq != seq)
+			continue;
+		pw->connectResultNotify(
+			req->port1_id, req->port2_id, req->is_connect, req->res);
+		qpwgraph_link_request_free(req);
+	}
+}
+
+static
+void qpwgraph_link_requests_clear ( qpwgraph_pipewire *pw )
+{
+	qpwgraph_pipewire::Data *pd = pw->data();
+
+	qpwgraph_link_request *req, *tmp;
+	spa_list_for_each_safe(req, tmp, &pd->link_requests, link)
+		qpwgraph_link_request_free(req);
+}
+// link-requests.
+
+
 // core-events...
 static
 void qpwgraph_core_event_info ( void *data, const struct pw_core_info *info )
@@ -579,8 +845,12 @@ void qpwgraph_core_event_info ( void *data, const struct pw_core_info *info )
 	qDebug("qpwgraph_core_event_info[%p]: name:%s", pd, info->name);
 #endif
 
-	pw->setRemoteName(info->name);
-	pw->changedNotify();
+	qpwgraph_pipewire::Event event;
+	spa_zero(event);
+	event.type = qpwgraph_pipewire::Event::CoreInfo;
+	event.id = info->id;
+	event.strs[0] = qpwgraph_event_strdup(info->name);
+	pw->pushEvent(event);
 }
 
 static
@@ -602,6 +872,23 @@ void qpwgraph_core_event_done ( void *data, uint32_t id, int seq )
 		pd->last_seq = seq;
 		if (pd->pending_seq == seq)
 			pw_thread_loop_signal(pd->loop, false);
+		qpwgraph_link_requests_done(pw, seq);
+		// Initial registry snapshot...
+		if (pd->sync_phase > 0 && pd->sync_seq == seq) {
+			if (pd->sync_phase < 2) {
+				// All globals are in, now for the node infos...
+				pd->sync_phase = 2;
+				pd->sync_seq = pw_core_sync(pd->core, PW_ID_CORE, 0);
+			} else {
+				// All done, now for the GUI...
+				pd->sync_phase = 0;
+				pd->sync_seq = 0;
+				qpwgraph_pipewire::Event event;
+				spa_zero(event);
+				event.type = qpwgraph_pipewire::Event::Synced;
+				pw->pushEvent(event);
+			}
+		}
 	}
 }
 
@@ -634,54 +921,17 @@ const struct pw_core_events qpwgraph_core_events = {
 // core-events.
 
 
-// link-events...
-static
-int qpwgraph_link_proxy_sync ( qpwgraph_pipewire *pw )
-{
-	qpwgraph_pipewire::Data *pd = pw->data();
-
-	if (pw_thread_loop_in_thread(pd->loop))
-		return 0;
-
-	pd->pending_seq = pw_proxy_sync((struct pw_proxy *)pd->core, pd->pending_seq);
-
-	while (true) {
-		pw_thread_loop_wait(pd->loop);
-		if (pd->error)
-			return pd->last_res;
-		if (pd->pending_seq == pd->last_seq)
-			break;
-	}
-
-	return 0;
-}
-
-static
-void qpwgraph_link_proxy_error ( void *data, int seq, int res, const char *message )
-{
-#ifdef CONFIG_DEBUG
-	qDebug("qpwgraph_link_proxy_error: seq:%d res:%d : %s", seq, res, message);
-#endif
-
-	int *link_res = (int *)data;
-	*link_res = res;
-}
-
-static
-const struct pw_proxy_events qpwgraph_link_proxy_events = {
-	.version = PW_VERSION_PROXY_EVENTS,
-	.error = qpwgraph_link_proxy_error,
-};
-// link-events.
-
-
 //----------------------------------------------------------------------------
 // qpwgraph_pipewire -- PipeWire graph driver
 
 // Constructor.
 qpwgraph_pipewire::qpwgraph_pipewire ( qpwgraph_canvas *canvas )
-	: qpwgraph_sect(canvas), m_data(nullptr)
+	: qpwgraph_sect(canvas), m_data(nullptr), m_resync(true),
+		m_synced(false), m_sync_msecs(-1)
 {
+	m_events = new qpwgraph_ring<Event> (MAX_EVENTS);
+	m_events_spill = new QList<Event>;
+
 	if (!open())
 		QTimer::singleShot(3000, this, SLOT(reset()));
 }
@@ -691,6 +941,9 @@ qpwgraph_pipewire::qpwgraph_pipewire ( qpwgraph_canvas *canvas )
 qpwgraph_pipewire::~qpwgraph_pipewire (void)
 {
 	close();
+
+	delete m_events_spill;
+	delete m_events;
 }
 
 
@@ -704,6 +957,7 @@ bool qpwgraph_pipewire::open (void)
 	m_data = new Data;
 	spa_zero(*m_data);
 	spa_list_init(&m_data->pending);
+	spa_list_init(&m_data->link_requests);
 	m_data->pending_seq = 0;
 
 	m_data->loop = pw_thread_loop_new("qpwgraph_thread_loop", nullptr);
@@ -757,11 +1011,28 @@ bool qpwgraph_pipewire::open (void)
 	pw_registry_add_listener(m_data->registry,
 		&m_data->registry_listener, &qpwgraph_registry_events, this);
 
+	// Initial registry snapshot: all globals, then all node infos...
+	m_data->sync_phase = 1;
+	m_data->sync_seq = pw_core_sync(m_data->core, PW_ID_CORE, 0);
+
+	m_synced = false;
+	m_sync_msecs = -1;
+	m_sync_time.start();
+
 	m_data->pending_seq = 0;
 	m_data->last_seq = 0;
 	m_data->error = false;
+	m_data->proxies = new Data::Proxies;
+	m_data->proxies_bound = 0;
+	m_data->proxies_deferred = 0;
 	m_data->node_names = new Data::NodeNames;
 
+	m_events_notify.storeRelease(0);
+	m_events_spilled.storeRelease(0);
+
+	m_changes.clear();
+	m_resync = true;
+
 	pw_thread_loop_start(m_data->loop);
 	pw_thread_loop_unlock(m_data->loop);
 	return true;
@@ -777,7 +1048,8 @@ void qpwgraph_pipewire::close (void)
 
 	pw_thread_loop_lock(m_data->loop);
 
-	clearObjects();
+	qpwgraph_link_requests_clear(this);
+	qpwgraph_proxies_clear(this);
 
 	pw_thread_loop_unlock(m_data->loop);
 
@@ -800,6 +1072,23 @@ void qpwgraph_pipewire::close (void)
 	if (m_data->loop)
 		pw_thread_loop_destroy(m_data->loop);
 
+	// Discard any still pending events...
+	Event event;
+	while (m_events->pop(event))
+		qpwgraph_event_free(event);
+
+	QList<Event>::Iterator iter = m_events_spill->begin();
+	const QList<Event>::Iterator& iter_end = m_events_spill->end();
+	for ( ; iter != iter_end; ++iter)
+		qpwgraph_event_free(*iter);
+	m_events_spill->clear();
+	m_events_spilled.storeRelease(0);
+
+	clearObjects();
+
+	if (m_data->proxies)
+		delete m_data->proxies;
+
 	if (m_data->node_names)
 		delete m_data->node_names;
 
@@ -829,81 +1118,223 @@ void qpwgraph_pipewire::changedNotify (void)
 }
 
 
+// PipeWire thread event queue (producer side).
+//
+// Called from the PipeWire thread-loop only: never blocks nor touches
+// the object database; the GUI thread is notified only once, until it
+// gets to dispatch the queued events. Should the queue ever overflow,
+// events get spilled to a (locked) list instead, and keep going there
+// until the GUI thread catches up, so that their order is kept.
+//
+void qpwgraph_pipewire::pushEvent ( const Event& event )
+{
+	bool pushed = false;
+
+	if (m_events_spilled.loadAcquire() == 0)
+		pushed = m_events->push(event);
+
+	if (!pushed) {
+		QMutexLocker locker(&m_events_mutex);
+		if (m_events_spilled.loadAcquire() == 0)
+			pushed = m_events->push(event);
+		if (!pushed) {
+			m_events_spill->append(event);
+			m_events_spilled.storeRelease(1);
+		}
+	}
+
+	// While on the initial snapshot, only when about half-full...
+	if (m_data && m_data->sync_phase > 0
+		&& m_events_spilled.loadAcquire() == 0
+		&& m_events->count() < m_events->size() / 2)
+		return;
+
+	if (m_events_notify.testAndSetOrdered(0, 1))
+		changedNotify();
+}
+
+
+// PipeWire thread event queue (consumer side).
+//
+// Called from the GUI thread only: this is where all object database
+// mutations take place, hence free from any locking.
+//
+void qpwgraph_pipewire::dispatchEvents (void)
+{
+	m_events_notify.storeRelease(0);
+
+	Event event;
+	while (m_events->pop(event))
+		dispatchEvent(event);
+
+	// Overflow events, only after all queued ones: while spilling, the
+	// producer stays off the ring, so whatever got in there meanwhile
+	// is older than any overflow event and must be drained first...
+	if (m_events_spilled.loadAcquire()) {
+		QList<Event> events;
+		m_events_mutex.lock();
+		while (m_events->pop(event))
+			events.append(event);
+	#ifdef CONFIG_DEBUG
+		qDebug("qpwgraph_pipewire::dispatchEvents: %d overflow events.",
+			int(m_events_spill->count()));
+	#endif
+		events.append(*m_events_spill);
+		m_events_spill->clear();
+		m_events_spilled.storeRelease(0);
+		m_events_mutex.unlock();
+		QList<Event>::Iterator iter = events.begin();
+		const QList<Event>::Iterator& iter_end = events.end();
+		for ( ; iter != iter_end; ++iter)
+			dispatchEvent(*iter);
+	}
+}
+
+
+void qpwgraph_pipewire::dispatchEvent ( Event& event )
+{
+	switch (event.type) {
+	case Event::NodeAdded:
+		createNode(event.id,
+			QString::fromUtf8(event.strs[0]),
+			QString::fromUtf8(event.strs[1]),
+			event.mode, event.node_types);
+		break;
+	case Event::NodeInfo:
+		updateNode(event.id,
+			event.strs[0], event.client_api, event.strs[1]);
+		break;
+	case Event::PortAdded:
+		createPort(event.id, event.node_id,
+			QString::fromUtf8(event.strs[0]),
+			event.mode, event.port_type, event.port_flags);
+		break;
+	case Event::LinkAdded:
+		createLink(event.id, event.port1_id, event.port2_id);
+		break;
+	case Event::Removed:
+		removeObject(event.id);
+		break;
+	case Event::CoreInfo:
+		setRemoteName(QString::fromUtf8(event.strs[0]));
+		break;
+	case Event::Synced:
+		m_synced = true;
+		break;
+	}
+
+	qpwgraph_event_free(event);
+}
+
+
+void qpwgraph_pipewire::connectResultNotify (
+	uint port1_id, uint port2_id, bool is_connect, int res )
+{
+	emit connectResult(port1_id, port2_id, is_connect, res);
+}
+
+
 // PipeWire port (dis)connection.
 void qpwgraph_pipewire::connectPorts (
 	qpwgraph_port *port1, qpwgraph_port *port2, bool is_connect )
 {
-	if (m_data == nullptr)
-		return;
+	qpwgraph_port::Pairs pairs;
+	pairs.append(qpwgraph_port::Pair(port1, port2));
 
-	if (port1 == nullptr || port2 == nullptr)
-		return;
+	connectPorts(pairs, is_connect);
+}
 
-	const qpwgraph_node *node1 = port1->portNode();
-	const qpwgraph_node *node2 = port2->portNode();
 
-	if (node1 == nullptr || node2 == nullptr)
+// PipeWire port (dis)connections, batched (asynchronous).
+//
+// All link requests are issued in one go, followed by a single core
+// sync round-trip; results are then reported per link, through the
+// connectResult() signal, as soon as the core is done with the batch.
+//
+void qpwgraph_pipewire::connectPorts (
+	const qpwgraph_port::Pairs& pairs, bool is_connect )
+{
+	if (m_data == nullptr)
 		return;
 
 	QMutexLocker locker1(&m_mutex1);
 
 	pw_thread_loop_lock(m_data->loop);
 
-	Port *p1 = findPort(port1->portId());
-	Port *p2 = findPort(port2->portId());
+	bool link_passive = false;
+	const char *str = ::getenv("PIPEWIRE_LINK_PASSIVE");
+	if (str && pw_properties_parse_bool(str))
+		link_passive = true;
 
-	if ((p1 == nullptr || p2 == nullptr) ||
-		(p1->port_mode & qpwgraph_item::Output) == 0 ||
-		(p2->port_mode & qpwgraph_item::Input)  == 0 ||
-		(p1->port_type != p2->port_type)) {
-		pw_thread_loop_unlock(m_data->loop);
-		return;
-	}
+	QList<qpwgraph_link_request *> reqs;
 
-	if (!is_connect) {
-		// Disconnect ports...
-		foreach (Link *link, p1->port_links) {
-			if ((link->port1_id == p1->id) &&
-				(link->port2_id == p2->id)) {
-				pw_registry_destroy(m_data->registry, link->id);
-				qpwgraph_link_proxy_sync(this);
-				break;
+	foreach (const qpwgraph_port::Pair& pair, pairs) {
+		qpwgraph_port *port1 = pair.first;
+		qpwgraph_port *port2 = pair.second;
+		if (port1 == nullptr || port2 == nullptr)
+			continue;
+		if (port1->portNode() == nullptr ||
+			port2->portNode() == nullptr)
+			continue;
+		Port *p1 = findPort(port1->portId());
+		Port *p2 = findPort(port2->portId());
+		if ((p1 == nullptr || p2 == nullptr) ||
+			(p1->port_mode & qpwgraph_item::Output) == 0 ||
+			(p2->port_mode & qpwgraph_item::Input)  == 0 ||
+			(p1->port_type != p2->port_type))
+			continue;
+		qpwgraph_link_request *req = new qpwgraph_link_request;
+		spa_zero(*req);
+		req->port1_id = p1->id;
+		req->port2_id = p2->id;
+		req->is_connect = is_connect;
+		req->res = 0;
+		if (is_connect) {
+			// Connect ports...
+			char val[4][16];
+			::snprintf(val[0], sizeof(val[0]), "%u", p1->node_id);
+			::snprintf(val[1], sizeof(val[1]), "%u", p1->id);
+			::snprintf(val[2], sizeof(val[2]), "%u", p2->node_id);
+			::snprintf(val[3], sizeof(val[3]), "%u", p2->id);
+			struct spa_dict props;
+			struct spa_dict_item items[6];
+			props = SPA_DICT_INIT(items, 0);
+			items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_LINK_OUTPUT_NODE, val[0]);
+			items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_LINK_OUTPUT_PORT, val[1]);
+			items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_LINK_INPUT_NODE,  val[2]);
+			items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_LINK_INPUT_PORT,  val[3]);
+			items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_OBJECT_LINGER,    "true");
+			if (link_passive)
+				items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_LINK_PASSIVE, "true");
+			req->proxy = (struct pw_proxy *)pw_core_create_object(m_data->core,
+				"link-factory", PW_TYPE_INTERFACE_Link, PW_VERSION_LINK, &props, 0);
+			if (req->proxy) {
+				pw_proxy_add_listener(req->proxy,
+					&req->listener, &qpwgraph_link_proxy_events, req);
+			} else {
+				req->res = -EIO;
+			}
+		} else {
+			// Disconnect ports...
+			req->res = -ENOENT;
+			for (const Link *link : p1->port_links) {
+				if ((link->port1_id == p1->id) &&
+					(link->port2_id == p2->id)) {
+					pw_registry_destroy(m_data->registry, link->id);
+					req->res = 0;
+					break;
+				}
 			}
 		}
-		pw_thread_loop_unlock(m_data->loop);
-		return;
+		spa_list_append(&m_data->link_requests, &req->link);
+		reqs.append(req);
 	}
 
-	// Connect ports...
-	char val[4][16];
-	::snprintf(val[0], sizeof(val[0]), "%u", p1->node_id);
-	::snprintf(val[1], sizeof(val[1]), "%u", p1->id);
-	::snprintf(val[2], sizeof(val[2]), "%u", p2->node_id);
-	::snprintf(val[3], sizeof(val[3]), "%u", p2->id);
-
-	struct spa_dict props;
-	struct spa_dict_item items[6];
-	props = SPA_DICT_INIT(items, 0);
-	items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_LINK_OUTPUT_NODE, val[0]);
-	items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_LINK_OUTPUT_PORT, val[1]);
-	items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_LINK_INPUT_NODE,  val[2]);
-	items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_LINK_INPUT_PORT,  val[3]);
-	items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_OBJECT_LINGER,    "true");
-	const char *str = ::getenv("PIPEWIRE_LINK_PASSIVE");
-	if (str && pw_properties_parse_bool(str))
-		items[props.n_items++] = SPA_DICT_ITEM_INIT(PW_KEY_LINK_PASSIVE, "true");
-
-	struct pw_proxy *proxy = (struct pw_proxy *)pw_core_create_object(m_data->core,
-		"link-factory", PW_TYPE_INTERFACE_Link, PW_VERSION_LINK, &props, 0);
-	if (proxy) {
-		int link_res = 0;
-		struct spa_hook listener;
-		spa_zero(listener);
-		pw_proxy_add_listener(proxy,
-			&listener, &qpwgraph_link_proxy_events, &link_res);
-		qpwgraph_link_proxy_sync(this);
-		spa_hook_remove(&listener);
-		pw_proxy_destroy(proxy);
+	// Just one core round-trip for the whole batch...
+	if (!reqs.isEmpty()) {
+		const int seq = pw_core_sync(m_data->core, PW_ID_CORE, 0);
+		foreach (qpwgraph_link_request *req, reqs)
+			req->seq = seq;
 	}
 
 	pw_thread_loop_unlock(m_data->loop);
@@ -963,6 +1394,20 @@ uint qpwgraph_pipewire::otherPortType (void)
 }
 
 
+// PipeWire media class and client API classifiers.
+void qpwgraph_pipewire::mediaClass ( const char *media_class,
+	qpwgraph_item::Mode& node_mode, uint& node_types )
+{
+	qpwgraph_media_class(media_class, node_mode, node_types);
+}
+
+
+uint qpwgraph_pipewire::clientApi ( const char *client_api )
+{
+	return qpwgraph_client_api(client_api);
+}
+
+
 // PipeWire node:port finder and creator if not existing.
 bool qpwgraph_pipewire::findNodePort (
 	uint node_id, uint port_id,  qpwgraph_item::Mode port_mode,
@@ -1011,7 +1456,7 @@ bool qpwgraph_pipewire::findNodePort (
 		*port = (*node)->findPort(port_id, port_mode, port_type);
 
 	if (add_new && *node == nullptr) {
-		QString node_name = n->node_name;
+		QString node_name = n->node_name.name();
 		if ((p->port_flags & Port::Physical) == Port::None) {
 			if (p->port_flags & Port::Monitor) {
 				node_name += ' ';
@@ -1036,6 +1481,7 @@ bool qpwgraph_pipewire::findNodePort (
 	}
 
 	if (add_new && *port == nullptr && *node) {
+		qpwgraph_sect::beginNodeEdit(*node);
 		*port = (*node)->addPort(port_id, p->port_name, port_mode, port_type);
 		(*port)->updatePortTypeColors(canvas);
 		(*port)->setPortLabelEx(true);
@@ -1056,7 +1502,6 @@ void qpwgraph_pipewire::updateItems (void)
 	qDebug("qpwgraph_pipewire::updateItems()");
 #endif
 	QMutexLocker locker1(&m_mutex1);
-	QMutexLocker locker2(&m_mutex2);
 
 	// 0. Check for core errors...
 	//
@@ -1065,17 +1510,58 @@ void qpwgraph_pipewire::updateItems (void)
 		return;
 	}
 
+	// Bring the object database up to date...
+	//
+	dispatchEvents();
+
+	// Still collecting the initial snapshot?...
+	//
+	if (!m_synced)
+		return;
+
+	// Full inventory, if due...
+	//
+	if (m_resync || m_changes.count() > MAX_CHANGES) {
+		m_changes.clear();
+		m_resync = false;
+		resyncItems();
+		// Time to first complete graph...
+		if (m_sync_msecs < 0) {
+			m_sync_msecs = m_sync_time.elapsed();
+		#ifdef CONFIG_DEBUG
+			qDebug("qpwgraph_pipewire::updateItems(): synced in %d msecs.",
+				int(m_sync_msecs));
+		#endif
+		}
+		return;
+	}
+
+	// Otherwise, just the nodes that changed...
+	//
+	QSet<uint> node_ids;
+	node_ids.swap(m_changes);
+
+	if (!node_ids.isEmpty())
+		updateNodeItems(node_ids);
+}
+
+
+// PipeWire graph full inventory.
+void qpwgraph_pipewire::resyncItems (void)
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qpwgraph_pipewire::resyncItems()");
+#endif
+
 	// 1. Nodes/ports inventory...
 	//
 	QList<qpwgraph_port *> ports;
 
-	foreach (Object *object, m_objects) {
-		if (object->type != Object::Node)
-			continue;
+	for (Object *object : m_objects[Object::Node]) {
 		Node *n1 = static_cast<Node *> (object);
 		if (!n1->node_ready)
 			continue;
-		foreach (const Port *p1, n1->node_ports) {
+		for (const Port *p1 : n1->node_ports) {
 			const qpwgraph_item::Mode port_mode1
 				= p1->port_mode;
 			qpwgraph_node *node1 = nullptr;
@@ -1092,13 +1578,21 @@ void qpwgraph_pipewire::updateItems (void)
 		}
 	}
 
-	// 2. Links inventory...
+	// Lay out all new ports, once per node...
 	//
+	qpwgraph_sect::commitNodeEdits();
+
+	// 2. Links inventory (new connection paths deferred)...
+	//
+	QList<qpwgraph_connect *> connects;
+
 	foreach (qpwgraph_port *port1, ports) {
 		Port *p1 = findPort(port1->portId());
 		if (p1 == nullptr)
 			continue;
-		foreach (const Link *link, p1->port_links) {
+		for (const Link *link : p1->port_links) {
+			if (link->port1_id != p1->id)
+				continue;
 			Port *p2 = findPort(link->port2_id);
 			if (p2 == nullptr)
 				continue;
@@ -1108,17 +1602,7 @@ void qpwgraph_pipewire::updateItems (void)
 			qpwgraph_port *port2 = nullptr;
 			if (findNodePort(p2->node_id, link->port2_id,
 					port_mode2, &node2, &port2, false)) {
-				qpwgraph_connect *connect = port1->findConnect(port2);
-				if (connect == nullptr) {
-					connect = new qpwgraph_connect();
-					connect->setPort1(port1);
-					connect->setPort2(port2);
-					connect->updatePortTypeColors();
-					connect->updatePath();
-					qpwgraph_sect::addItem(connect);
-				}
-				if (connect)
-					connect->setMarked(true);
+				updateConnect(port1, port2, &connects);
 			}
 		}
 	}
@@ -1126,6 +1610,132 @@ void qpwgraph_pipewire::updateItems (void)
 	// 3. Clean-up all un-marked items...
 	//
 	qpwgraph_sect::resetItems(qpwgraph_pipewire::nodeType());
+
+	// 4. Finally, all new connection paths in one go...
+	//
+	foreach (qpwgraph_connect *connect, connects)
+		connect->updatePath();
+
+#ifdef CONFIG_DEBUG
+	qDebug("qpwgraph_pipewire::resyncItems(): proxies bound:%u deferred:%u",
+		proxiesBound(), proxiesDeferred());
+#endif
+}
+
+
+// PipeWire graph delta updater (changed nodes only).
+void qpwgraph_pipewire::updateNodeItems ( const QSet<uint>& node_ids )
+{
+#ifdef CONFIG_DEBUG
+	qDebug("qpwgraph_pipewire::updateNodeItems(%d)", int(node_ids.count()));
+#endif
+
+	// 1. Current nodes, as they might get stale...
+	//
+	QSet<qpwgraph_node *> nodes;
+
+	foreach (uint node_id, node_ids)
+		findNodeItems(node_id, nodes);
+
+	// 2. Nodes/ports inventory...
+	//
+	QSet<const Link *> links;
+
+	foreach (uint node_id, node_ids) {
+		Node *n1 = findNode(node_id);
+		if (n1 == nullptr || !n1->node_ready)
+			continue;
+		for (const Port *p1 : n1->node_ports) {
+			qpwgraph_node *node1 = nullptr;
+			qpwgraph_port *port1 = nullptr;
+			if (findNodePort(n1->id, p1->id,
+					p1->port_mode, &node1, &port1, true)) {
+				node1->setMarked(true);
+				port1->setMarked(true);
+				for (const Link *link : p1->port_links)
+					links.insert(link);
+			}
+		}
+	}
+
+	// Lay out all new ports, once per node...
+	//
+	qpwgraph_sect::commitNodeEdits();
+
+	// 3. New nodes, if any...
+	//
+	foreach (uint node_id, node_ids)
+		findNodeItems(node_id, nodes);
+
+	// 4. Links inventory, either way...
+	//
+	foreach (const Link *link, links) {
+		Port *p1 = findPort(link->port1_id);
+		if (p1 == nullptr)
+			continue;
+		Port *p2 = findPort(link->port2_id);
+		if (p2 == nullptr)
+			continue;
+		qpwgraph_node *node1 = nullptr;
+		qpwgraph_port *port1 = nullptr;
+		if (!findNodePort(p1->node_id, p1->id,
+				qpwgraph_item::Output, &node1, &port1, false))
+			continue;
+		qpwgraph_node *node2 = nullptr;
+		qpwgraph_port *port2 = nullptr;
+		if (!findNodePort(p2->node_id, p2->id,
+				qpwgraph_item::Input, &node2, &port2, false))
+			continue;
+		updateConnect(port1, port2);
+	}
+
+	// 5. Clean-up un-marked items of those nodes only...
+	//
+	qpwgraph_sect::resetNodeItems(nodes);
+}
+
+
+// PipeWire graph node items finder (all modes).
+void qpwgraph_pipewire::findNodeItems (
+	uint node_id, QSet<qpwgraph_node *>& nodes ) const
+{
+	static const qpwgraph_item::Mode node_modes[] = {
+		qpwgraph_item::Input,
+		qpwgraph_item::Output,
+		qpwgraph_item::Duplex
+	};
+
+	const uint node_type = qpwgraph_pipewire::nodeType();
+
+	for (const qpwgraph_item::Mode node_mode : node_modes) {
+		qpwgraph_node *node
+			= qpwgraph_sect::findNode(node_id, node_mode, node_type);
+		if (node)
+			nodes.insert(node);
+	}
+}
+
+
+// PipeWire graph connection finder and creator if not existing.
+qpwgraph_connect *qpwgraph_pipewire::updateConnect (
+	qpwgraph_port *port1, qpwgraph_port *port2,
+	QList<qpwgraph_connect *> *connects )
+{
+	qpwgraph_connect *connect = port1->findConnect(port2);
+	if (connect == nullptr) {
+		connect = new qpwgraph_connect();
+		connect->setPort1(port1);
+		connect->setPort2(port2);
+		connect->updatePortTypeColors();
+		if (connects)
+			connects->append(connect);
+		else
+			connect->updatePath();
+		qpwgraph_sect::addItem(connect);
+	}
+
+	connect->setMarked(true);
+	return connect;
 }
 
 
@@ -1142,6 +1752,10 @@ void qpwgraph_pipewire::clearItems (void)
 	// Clean-up all items...
 	//
 	qpwgraph_sect::clearItems(qpwgraph_pipewire::nodeType());
+
+	// A full inventory is due...
+	m_changes.clear();
+	m_resync = true;
 }
 
 
@@ -1194,54 +1808,77 @@ qpwgraph_pipewire::Object *qpwgraph_pipewire::findObject ( uint id ) const
 
 void qpwgraph_pipewire::addObject ( uint id, Object *object )
 {
-	object->create_proxy(this);
-
 	m_objectids.insert(id, object);
-	m_objects.append(object);
+	m_objects[object->type].append(&object->object_item);
+
+	if (object->type == Object::Node)
+		addChange(id);
+	else
+	if (object->type == Object::Port)
+		addChange(static_cast<Port *> (object)->node_id);
+	else
+	if (object->type == Object::Link) {
+		const Port *port1 = findPort(static_cast<Link *> (object)->port1_id);
+		if (port1)
+			addChange(port1->node_id);
+	}
 }
 
 
 void qpwgraph_pipewire::removeObject ( uint id )
 {
 	Object *object = findObject(id);
-	if (object == nullptr)
-		return;
+	if (object)
+		removeObject(object);
+}
+
+
+void qpwgraph_pipewire::removeObject ( Object *object )
+{
+	const uint id = object->id;
 
 	m_objectids.remove(id);
-	m_objects.removeAll(object);
+	m_objects[object->type].remove(&object->object_item);
 
-	if (object->type == Object::Node)
+	if (object->type == Object::Node) {
+		addChange(id);
 		destroyNode(static_cast<Node *> (object));
+	}
 	else
-	if (object->type == Object::Port)
+	if (object->type == Object::Port) {
+		addChange(static_cast<Port *> (object)->node_id);
 		destroyPort(static_cast<Port *> (object));
+	}
 	else
-	if (object->type == Object::Link)
+	if (object->type == Object::Link) {
+		const Port *port1 = findPort(static_cast<Link *> (object)->port1_id);
+		if (port1)
+			addChange(port1->node_id);
 		destroyLink(static_cast<Link *> (object));
+	}
 }
 
 
 void qpwgraph_pipewire::clearObjects (void)
 {
-	qDeleteAll(m_objects);
-	m_objects.clear();
-	m_objectids.clear();
-}
-
-
-void qpwgraph_pipewire::removeObjectEx ( uint id )
-{
-	QMutexLocker locker2(&m_mutex2);
+	for (qpwgraph_list<Object>& objects : m_objects) {
+		while (!objects.isEmpty())
+			delete objects.first()->object();
+	}
 
-	removeObject(id);
+	m_objectids.clear();
 }
 
 
-void qpwgraph_pipewire::addObjectEx ( uint id, Object *object )
+// PipeWire graph change journal (changed node ids).
+//
+void qpwgraph_pipewire::addChange ( uint node_id )
 {
-	QMutexLocker locker2(&m_mutex2);
+	// No point on journaling when a full inventory is due anyway...
+	if (m_resync || m_changes.count() > MAX_CHANGES)
+		return;
 
-	addObject(id, object);
+	m_changes.insert(node_id);
 }
 
 
@@ -1262,8 +1899,8 @@ qpwgraph_pipewire::Node *qpwgraph_pipewire::createNode (
 	uint node_type )
 {
 	Node *node = new Node(node_id);
-	node->node_name = node_name;
-	node->node_nick = node_nick;
+	node->node_name = qpwgraph_atom(node_name);
+	node->node_nick = qpwgraph_atom(node_nick);
 	node->node_mode = node_mode;
 	node->node_type = Node::NodeType(node_type);
 	node->node_mode2 = node_mode;
@@ -1285,12 +1922,46 @@ qpwgraph_pipewire::Node *qpwgraph_pipewire::createNode (
 		node_names->insert(name_key, node->name_num);
 	}
 
-	addObjectEx(node_id, node);
+	addObject(node_id, node);
 
 	return node;
 }
 
 
+void qpwgraph_pipewire::updateNode (
+	uint node_id,
+	const char *icon_name,
+	uint client_api,
+	const char *media_name )
+{
+	Node *node = findNode(node_id);
+	if (node == nullptr)
+		return;
+
+	// Get node icon and media.name, if any...
+	QIcon node_icon;
+	if (icon_name)
+		node_icon = qpwgraph_icon(icon_name);
+	if (node_icon.isNull())
+		node_icon = qpwgraph_icon(node->node_name.name().toLower());
+	if (node_icon.isNull()) {
+		if (client_api == Node::Jack)
+			node_icon = qpwgraph_icon(":images/itemJack.png");
+		else
+		if (client_api == Node::Pulse)
+			node_icon = qpwgraph_icon(":images/itemPulse.png");
+	}
+	if (!node_icon.isNull())
+		node->node_icon = node_icon;
+	if (media_name)
+		node->media_name = media_name;
+	node->node_changed = true;
+	node->node_ready = true;
+
+	addChange(node_id);
+}
+
+
 void qpwgraph_pipewire::destroyNode ( Node *node )
 {
 	Data::NodeNames *node_names = nullptr;
@@ -1299,10 +1970,8 @@ void qpwgraph_pipewire::destroyNode ( Node *node )
 	if (node_names)
 		node_names->remove(Node::NameKey(node), node->name_num);
 
-	foreach (const Port *port, node->node_ports)
-		removeObject(port->id);
-
-	node->node_ports.clear();
+	while (!node->node_ports.isEmpty())
+		removeObject(node->node_ports.first()->object());
 
 	delete node;
 }
@@ -1329,9 +1998,20 @@ qpwgraph_pipewire::Port *qpwgraph_pipewire::createPort (
 	if (node == nullptr)
 		return nullptr;
 
+	// Port type and flags as inferred from its node...
+	if (port_type == 0) {
+		if (node->node_type == Node::Video)
+			port_type = qpwgraph_pipewire::videoPortType();
+		else
+			port_type = qpwgraph_pipewire::otherPortType();
+	}
+
+	if (node->node_mode != qpwgraph_item::Duplex)
+		port_flags |= Port::Terminal;
+
 	Port *port = new Port(port_id);
 	port->node_id = node_id;
-	port->port_name = port_name;
+	port->port_name = qpwgraph_atom(port_name);
 	port->port_mode = port_mode;
 	port->port_type = port_type;
 	port->port_flags = Port::Flags(port_flags);
@@ -1342,10 +2022,10 @@ qpwgraph_pipewire::Port *qpwgraph_pipewire::createPort (
 	if ((node->node_mode2 & port_mode) == qpwgraph_item::None)
 		node->node_mode2 = qpwgraph_item::Duplex;
 
-	node->node_ports.append(port);
+	node->node_ports.append(&port->node_item);
 	node->node_changed = true;
 
-	addObjectEx(port_id, port);
+	addObject(port_id, port);
 
 	return port;
 }
@@ -1354,15 +2034,11 @@ qpwgraph_pipewire::Port *qpwgraph_pipewire::createPort (
 void qpwgraph_pipewire::destroyPort ( Port *port )
 {
 	Node *node = findNode(port->node_id);
-	if (node == nullptr)
-		return;
+	if (node)
+		node->node_changed = true;
 
-	foreach (const Link *link, port->port_links)
-		removeObject(link->id);
-
-	port->port_links.clear();
-	node->node_ports.removeAll(port);
-	node->node_changed = true;
+	while (!port->port_links.isEmpty())
+		removeObject(port->port_links.first()->object());
 
 	delete port;
 }
@@ -1396,9 +2072,10 @@ qpwgraph_pipewire::Link *qpwgraph_pipewire::createLink (
 	link->port1_id = port1_id;
 	link->port2_id = port2_id;
 
-	port1->port_links.append(link);
+	port1->port_links.append(&link->port1_item);
+	port2->port_links.append(&link->port2_item);
 
-	addObjectEx(link_id, link);
+	addObject(link_id, link);
 
 	return link;
 }
@@ -1406,13 +2083,59 @@ qpwgraph_pipewire::Link *qpwgraph_pipewire::createLink (
 
 void qpwgraph_pipewire::destroyLink ( Link *link )
 {
-	Port *port = findPort(link->port1_id);
-	if (port == nullptr)
-		return;
+	// Unlinks from both ports, if still around...
+	delete link;
+}
 
-	port->port_links.removeAll(link);
 
-	delete link;
+// Proxy binding counters (bound vs. never bound, since open).
+uint qpwgraph_pipewire::proxiesBound (void) const
+{
+	if (m_data == nullptr)
+		return 0;
+
+	pw_thread_loop_lock(m_data->loop);
+	const uint ret = m_data->proxies_bound;
+	pw_thread_loop_unlock(m_data->loop);
+
+	return ret;
+}
+
+
+uint qpwgraph_pipewire::proxiesDeferred (void) const
+{
+	if (m_data == nullptr)
+		return 0;
+
+	pw_thread_loop_lock(m_data->loop);
+	const uint ret = m_data->proxies_deferred;
+	pw_thread_loop_unlock(m_data->loop);
+
+	return ret;
+}
+
+
+// PipeWire port display name ("node:port"), if still around.
+QString qpwgraph_pipewire::portName ( uint port_id ) const
+{
+	const Port *p = findPort(port_id);
+	if (p == nullptr)
+		return QString();
+
+	// As (possibly renamed) on the canvas, if shown...
+	qpwgraph_node *node = findNode(p->node_id, p->port_mode);
+	if (node) {
+		qpwgraph_port *port
+			= node->findPort(port_id, p->port_mode, p->port_type);
+		if (port)
+			return node->nodeTitle() + ':' + port->portTitle();
+	}
+
+	const Node *n = findNode(p->node_id);
+	if (n == nullptr)
+		return QString();
+
+	return n->node_name.name() + ':' + p->port_name.name();
 }
 
 
@@ -24,10 +24,15 @@
 
 #include "config.h"
 #include "qpwgraph_sect.h"
+#include "qpwgraph_list.h"
+#include "qpwgraph_ring.h"
 
 #include <QHash>
+#include <QSet>
 
 #include <QMutex>
+#include <QAtomicInt>
+#include <QElapsedTimer>
 
 
 //----------------------------------------------------------------------------
@@ -52,9 +57,15 @@ public:
 	// Callback notifiers.
 	void changedNotify();
 
+	void connectResultNotify(
+		uint port1_id, uint port2_id, bool is_connect, int res);
+
 	// PipeWire port (dis)connection.
 	void connectPorts(qpwgraph_port *port1, qpwgraph_port *port2, bool is_connect);
 
+	// PipeWire port (dis)connections, batched (asynchronous).
+	void connectPorts(const qpwgraph_port::Pairs& pairs, bool is_connect);
+
 	// PipeWire graph updaters.
 	void updateItems();
 	void clearItems();
@@ -76,13 +87,23 @@ public:
 	static uint videoPortType();
 	static uint otherPortType();
 
+	// PipeWire media class classifier (node mode and types).
+	static void mediaClass(const char *media_class,
+		qpwgraph_item::Mode& node_mode, uint& node_types);
+	// PipeWire client API classifier (native, jack or pulse).
+	static uint clientApi(const char *client_api);
+
 	// Node/port renaming method (virtual override).
 	void renameItem(qpwgraph_item *item, const QString& name);
 
+	// PipeWire port display name ("node:port"), if still around.
+	QString portName(uint port_id) const;
+
 	// PipeWire client data struct access.
 	//
 	struct Data;
 	struct Proxy;
+	struct Event;
 	struct Object;
 	struct Node;
 	struct Port;
@@ -90,14 +111,18 @@ public:
 
 	Data *data() const;
 
+	// PipeWire thread event queue (producer side).
+	void pushEvent(const Event& event);
+
 	// Object methods...
 	Object *findObject(uint id) const;
 	void addObject(uint id, Object *object);
 	void removeObject(uint id);
+	void removeObject(Object *object);
 	void clearObjects();
 
-	void addObjectEx(uint id, Object *object);
-	void removeObjectEx(uint id);
+	// PipeWire graph change journal (changed node ids).
+	void addChange(uint node_id);
 
 	// Node methods....
 	Node *findNode(uint node_id) const;
@@ -107,6 +132,11 @@ public:
 		const QString& node_nick,
 		qpwgraph_item::Mode node_mode,
 		uint node_type);
+	void updateNode(
+		uint node_id,
+		const char *icon_name,
+		uint client_api,
+		const char *media_name);
 	void destroyNode(Node *node);
 
 	// Port methods....
@@ -125,6 +155,10 @@ public:
 	Link *createLink(uint link_id, uint port1_id, uint port2_id);
 	void destroyLink(Link *link);
 
+	// Proxy binding counters (bound vs. never bound, since open).
+	uint proxiesBound() const;
+	uint proxiesDeferred() const;
+
 	// Remote name accessors.
 	void setRemoteName(const QString& remote_name);
 	const QString& remoteName() const;
@@ -133,12 +167,19 @@ signals:
 
 	void changed();
 
+	// Port (dis)connection results (zero or negative errno).
+	void connectResult(uint port1_id, uint port2_id, bool is_connect, int res);
+
 public slots:
 
 	void reset();
 
 protected:
 
+	// PipeWire thread event queue (consumer side).
+	void dispatchEvents();
+	void dispatchEvent(Event& event);
+
 	// PipeWire node:port finder and creator if not existing.
 	bool findNodePort(
 		uint node_id, uint port_id, qpwgraph_item::Mode port_mode,
@@ -147,21 +188,53 @@ protected:
 	// Special node finder...
 	qpwgraph_node *findNode(uint node_id, qpwgraph_item::Mode node_mode) const;
 
+	// PipeWire graph updaters (full inventory vs. journaled deltas).
+	void resyncItems();
+	void updateNodeItems(const QSet<uint>& node_ids);
+
+	void findNodeItems(uint node_id, QSet<qpwgraph_node *>& nodes) const;
+
+	qpwgraph_connect *updateConnect(qpwgraph_port *port1, qpwgraph_port *port2,
+		QList<qpwgraph_connect *> *connects = nullptr);
+
 private:
 
 	// PipeWire client impl.
 	Data *m_data;
 
+	// PipeWire thread to GUI thread event queue.
+	qpwgraph_ring<Event> *m_events;
+
+	QAtomicInt m_events_notify;
+
+	// Overflow events (spilled, in order, while the queue is full).
+	QMutex m_events_mutex;
+	QList<Event> *m_events_spill;
+	QAtomicInt m_events_spilled;
+
 	// PipeWire object database.
 	QHash<uint, Object *> m_objectids;
-	QList<Object *> m_objects;
+
+	// Object store, one list per object type.
+	qpwgraph_list<Object> m_objects[3];
+
+	// PipeWire graph change journal (changed node ids).
+	QSet<uint> m_changes;
+
+	// Whether a full inventory is due.
+	bool m_resync;
+
+	// Whether the initial registry snapshot is complete.
+	bool m_synced;
+
+	QElapsedTimer m_sync_time;
+	qint64 m_sync_msecs;
 
 	qpwgraph_node::NodeIds m_recycled_nodes;
 	qpwgraph_port::PortIds m_recycled_ports;
 
 	// Callback sanity mutex.
 	QMutex m_mutex1;
-	QMutex m_mutex2;
 
 	// PipeWire remote daemon name.
 	QString m_remote_name;
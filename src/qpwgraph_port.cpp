@@ -45,7 +45,7 @@ qpwgraph_port::qpwgraph_port ( qpwgraph_node *node, uint id,
 		m_name(name), m_mode(mode), m_type(type),
 		m_index(node->ports().count()),
 		m_selectx(0), m_hilitex(0),
-		m_label_ex(false)
+		m_label_ex(false), m_simplified(false)
 {
 	QGraphicsPathItem::setZValue(+1.0);
 
@@ -60,6 +60,8 @@ qpwgraph_port::qpwgraph_port ( qpwgraph_node *node, uint id,
 
 	QGraphicsPathItem::setAcceptHoverEvents(true);
 
+	m_name_key = sortKey(m_name.name());
+
 	setPortTitle(QString());
 }
 
@@ -90,13 +92,20 @@ uint qpwgraph_port::portId (void) const
 
 void qpwgraph_port::setPortName ( const QString& name )
 {
-	m_name = name;
+	m_name = qpwgraph_atom(name);
+	m_name_key = sortKey(name);
 
 	QGraphicsPathItem::setToolTip(portNameLabelEx());
 }
 
 
 const QString& qpwgraph_port::portName (void) const
+{
+	return m_name.name();
+}
+
+
+const qpwgraph_atom& qpwgraph_port::portNameAtom (void) const
 {
 	return m_name;
 }
@@ -154,7 +163,7 @@ const QString& qpwgraph_port::portLabel (void) const
 
 QString qpwgraph_port::portNameLabel (void) const
 {
-	QString label = m_name;
+	QString label = m_name.name();
 
 	if (!m_label.isEmpty()) {
 		label += ' ';
@@ -172,6 +181,7 @@ void qpwgraph_port::setPortTitle ( const QString& title )
 	const QString& name_label = portNameLabel();
 
 	m_title = (title.isEmpty() ? name_label : title);
+	m_title_key = sortKey(m_title);
 
 	static const int MAX_TITLE_LENGTH = 29;
 	static const QString ellipsis(3, '.');
@@ -334,11 +344,19 @@ void qpwgraph_port::paint ( QPainter *painter,
 			port_color = background;
 		}
 	}
-	port_grad.setColorAt(0.0, port_color);
-	port_grad.setColorAt(1.0, port_color.darker(120));
-	painter->setBrush(port_grad);
 
-	painter->drawPath(QGraphicsPathItem::path());
+	const qreal lod = option->levelOfDetailFromTransform(
+		painter->worldTransform());
+	if (lod < qpwgraph_node::simplifyZoom()) {
+		// Simplified (flat) drawing...
+		painter->setBrush(port_color);
+		painter->drawRect(port_rect);
+	} else {
+		port_grad.setColorAt(0.0, port_color);
+		port_grad.setColorAt(1.0, port_color.darker(120));
+		painter->setBrush(port_grad);
+		painter->drawPath(QGraphicsPathItem::path());
+	}
 }
 
 
@@ -347,7 +365,7 @@ QVariant qpwgraph_port::itemChange (
 {
 	if (change == QGraphicsItem::ItemScenePositionHasChanged) {
 		foreach (qpwgraph_connect *connect, m_connects) {
-			connect->updatePath();
+			connect->invalidatePath();
 		}
 	}
 	else
@@ -473,62 +491,72 @@ bool qpwgraph_port::lessThan ( qpwgraph_port *port1, qpwgraph_port *port2 )
 			return (port_index_diff < 0);
 	}
 
+	// Plain binary compare of the cached keys...
 	switch (g_sort_type) {
 	case PortTitle:
-		return qpwgraph_port::lessThan(port1->portTitle(), port2->portTitle());
+		return (port1->m_title_key < port2->m_title_key);
 	case PortName:
 	default:
-		return qpwgraph_port::lessThan(port1->portName(), port2->portName());
+		return (port1->m_name_key < port2->m_name_key);
 	}
 }
 
-bool qpwgraph_port::lessThan ( const QString& s1, const QString& s2 )
-{
-	const int n1 = s1.length();
-	const int n2 = s2.length();
-
-	int i1, i2;
-
-	for (i1 = i2 = 0; i1 < n1 && i2 < n2; ++i1, ++i2) {
-
-		// Skip (white)spaces...
-		while (s1.at(i1).isSpace())
-			++i1;
-		while (s2.at(i2).isSpace())
-			++i2;
-
-		// Normalize (to uppercase) the next characters...
-		QChar c1 = s1.at(i1).toUpper();
-		QChar c2 = s2.at(i2).toUpper();
-
-		if (c1.isDigit() && c2.isDigit()) {
-			// Find the whole length numbers...
-			int j1 = i1++;
-			while (i1 < n1 && s1.at(i1).isDigit())
-				++i1;
-			int j2 = i2++;
-			while (i2 < n2 && s2.at(i2).isDigit())
-				++i2;
-			// Compare as natural decimal-numbers...
-			j1 = s1.mid(j1, i1 - j1).toInt();
-			j2 = s2.mid(j2, i2 - j2).toInt();
-			if (j1 != j2)
-				return (j1 < j2);
-			// Never go out of bounds...
-			if (i1 >= n1 || i2 >= n2)
-				break;
-			// Go on with this next char...
-			c1 = s1.at(i1).toUpper();
-			c2 = s2.at(i2).toUpper();
-		}
 
-		// Compare this char...
-		if (c1 != c2)
-			return (c1 < c2);
+// Natural decimal sorting (binary collation) key (static)
+//
+// Each character is encoded as a big-endian 16-bit code unit, so that
+// byte-wise order matches character order: (white)spaces are skipped;
+// letters are normalized to uppercase; any decimal-number run becomes
+// one single '0' unit, followed by its (leading zeros stripped) number
+// of digits and then the digits themselves, so that numbers compare
+// by their natural value. As with the former character by character
+// comparator, the (white)spaces right after a number are not skipped
+// but count as one single space (eg. "in 2 R" sorts before "in 2-aux").
+//
+QByteArray qpwgraph_port::sortKey ( const QString& s )
+{
+	QByteArray key;
+
+	const int n = s.length();
+	key.reserve(n << 1);
+
+	for (int i = 0; i < n; ++i) {
+		const QChar& ch = s.at(i);
+		if (ch.isSpace())
+			continue;
+		if (ch.isDigit()) {
+			// Find the whole length number...
+			while (i < n - 1 && s.at(i) == '0' && s.at(i + 1).isDigit())
+				++i;
+			int j = i;
+			while (j < n && s.at(j).isDigit())
+				++j;
+			key.append(char(0));
+			key.append('0');
+			key.append(char((j - i) >> 8));
+			key.append(char((j - i) & 0xff));
+			for ( ; i < j; ++i) {
+				key.append(char(0));
+				key.append(char('0' + s.at(i).digitValue()));
+			}
+			// A (white)space right after the number still counts...
+			if (i < n && s.at(i).isSpace()) {
+				key.append(char(0));
+				key.append(' ');
+				while (i < n - 1 && s.at(i + 1).isSpace())
+					++i;
+				continue;
+			}
+			--i;
+			continue;
+		}
+		// Normalize (to uppercase) this character...
+		const ushort u = ch.toUpper().unicode();
+		key.append(char(u >> 8));
+		key.append(char(u & 0xff));
 	}
 
-	// Probable exact match.
-	return false;
+	return key;
 }
 
 
@@ -539,4 +567,22 @@ QRectF qpwgraph_port::editorRect (void) const
 }
 
 
+// Level-of-detail mode (no text when zoomed out).
+void qpwgraph_port::setSimplified ( bool simplified )
+{
+	if (m_simplified == simplified)
+		return;
+
+	m_simplified = simplified;
+
+	m_text->setVisible(!m_simplified);
+}
+
+
+bool qpwgraph_port::isSimplified (void) const
+{
+	return m_simplified;
+}
+
+
 // end of qpwgraph_port.cpp
@@ -24,6 +24,9 @@
 
 #include "qpwgraph_item.h"
 
+#include <QPair>
+#include <QByteArray>
+
 
 // Forward decls.
 class qpwgraph_canvas;
@@ -59,6 +62,7 @@ public:
 
 	void setPortName(const QString& name);
 	const QString& portName() const;
+	const qpwgraph_atom& portNameAtom() const;
 
 	void setPortMode(Mode mode);
 	Mode portMode() const;
@@ -122,14 +126,18 @@ public:
 	{
 	public:
 		// Constructors.
-		PortNameKey (const QString& name, Mode mode, uint type = 0)
+		PortNameKey (const qpwgraph_atom& name, Mode mode, uint type = 0)
 			: NameKey(name, mode, type) {}
 		PortNameKey(qpwgraph_port *port)
-			: NameKey(port->portName(), port->portMode(), port->portType()) {}
+			: NameKey(port->portNameAtom(), port->portMode(), port->portType()) {}
 	};
 
 	typedef QHash<PortNameKey, qpwgraph_port *> PortNames;
 
+	// Port (dis)connection pairs (output, input).
+	typedef QPair<qpwgraph_port *, qpwgraph_port *> Pair;
+	typedef QList<Pair> Pairs;
+
 	// Port sorting type.
 	enum SortType { PortName = 0, PortTitle, PortIndex };
 
@@ -153,9 +161,16 @@ public:
 			{ return (port1->scenePos().y() < port2->scenePos().y()); }
 	};
 
+	// Natural decimal sorting (binary collation) key.
+	static QByteArray sortKey(const QString& s);
+
 	// Rectangular editor extents.
 	QRectF editorRect() const;
 
+	// Level-of-detail mode (no text when zoomed out).
+	void setSimplified(bool simplified);
+	bool isSimplified() const;
+
 protected:
 
 	void paint(QPainter *painter,
@@ -163,9 +178,8 @@ protected:
 
 	QVariant itemChange(GraphicsItemChange change, const QVariant& value);
 
-	// Natural decimal sorting comparators.
+	// Natural decimal sorting comparator.
 	static bool lessThan(qpwgraph_port *port1, qpwgraph_port *port2);
-	static bool lessThan(const QString& s1, const QString& s2);
 
 private:
 
@@ -173,7 +187,7 @@ private:
 	qpwgraph_node *m_node;
 
 	uint    m_id;
-	QString m_name;
+	qpwgraph_atom m_name;
 	Mode    m_mode;
 	uint    m_type;
 
@@ -181,6 +195,9 @@ private:
 	QString m_title;
 	int     m_index;
 
+	QByteArray m_name_key;
+	QByteArray m_title_key;
+
 	QGraphicsTextItem *m_text;
 
 	QList<qpwgraph_connect *> m_connects;
@@ -190,6 +207,8 @@ private:
 
 	bool m_label_ex;
 
+	bool m_simplified;
+
 	static SortType  g_sort_type;
 	static SortOrder g_sort_order;
 };
@@ -0,0 +1,103 @@
+// qpwgraph_ring.h
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qpwgraph_ring_h
+#define __qpwgraph_ring_h
+
+#include <QAtomicInteger>
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_ring -- Lock-free single-producer/single-consumer ring-buffer.
+//
+// Fixed capacity (rounded up to a power of two); push() is only ever
+// called from the one producer thread and pop() from the one consumer
+// thread. Indexes are free running and wrap around unsigned arithmetic.
+//
+
+template <typename T>
+class qpwgraph_ring
+{
+public:
+
+	// Constructor.
+	qpwgraph_ring(uint size) : m_size(4), m_read(0), m_write(0)
+	{
+		while (m_size < size)
+			m_size <<= 1;
+		m_mask = m_size - 1;
+		m_items = new T [m_size];
+	}
+
+	// Destructor.
+	~qpwgraph_ring() { delete [] m_items; }
+
+	// Accessors.
+	uint size() const { return m_size; }
+
+	uint count() const
+		{ return m_write.loadAcquire() - m_read.loadAcquire(); }
+
+	bool isEmpty() const
+		{ return m_write.loadAcquire() == m_read.loadAcquire(); }
+
+	// Producer side: false if full.
+	bool push(const T& item)
+	{
+		const uint w = m_write.loadAcquire();
+		if (w - m_read.loadAcquire() >= m_size)
+			return false;
+		m_items[w & m_mask] = item;
+		m_write.storeRelease(w + 1);
+		return true;
+	}
+
+	// Consumer side: false if empty.
+	bool pop(T& item)
+	{
+		const uint r = m_read.loadAcquire();
+		if (r == m_write.loadAcquire())
+			return false;
+		item = m_items[r & m_mask];
+		m_read.storeRelease(r + 1);
+		return true;
+	}
+
+private:
+
+	// Not copyable.
+	qpwgraph_ring(const qpwgraph_ring&) = delete;
+	qpwgraph_ring& operator= (const qpwgraph_ring&) = delete;
+
+	// Instance variables.
+	uint m_size;
+	uint m_mask;
+
+	T *m_items;
+
+	QAtomicInteger<uint> m_read;
+	QAtomicInteger<uint> m_write;
+};
+
+
+#endif	// __qpwgraph_ring_h
+
+// end of qpwgraph_ring.h
@@ -58,6 +58,9 @@ void qpwgraph_sect::addItem ( qpwgraph_item *item, bool is_new )
 
 void qpwgraph_sect::removeItem ( qpwgraph_item *item )
 {
+	// Canvas goes first, while connections are still attached...
+	m_canvas->removeItem(item);
+
 	if (item->type() == qpwgraph_connect::Type) {
 		qpwgraph_connect *connect = static_cast<qpwgraph_connect *> (item);
 		if (connect) {
@@ -65,8 +68,6 @@ void qpwgraph_sect::removeItem ( qpwgraph_item *item )
 			m_connects.removeAll(connect);
 		}
 	}
-
-	m_canvas->removeItem(item);
 }
 
 
@@ -88,6 +89,52 @@ void qpwgraph_sect::resetItems ( uint node_type )
 }
 
 
+// Clean-up un-marked items of the given nodes only...
+void qpwgraph_sect::resetNodeItems ( const QSet<qpwgraph_node *>& nodes )
+{
+	// Un-marked connections are gone when found on any of the given
+	// nodes output ports, or else on any un-marked (stale) port...
+	QSet<qpwgraph_connect *> connects1;
+	QSet<qpwgraph_connect *> connects2;
+
+	foreach (qpwgraph_node *node, nodes) {
+		foreach (qpwgraph_port *port, node->ports()) {
+			foreach (qpwgraph_connect *connect, port->connects()) {
+				if (connect->isMarked())
+					connects2.insert(connect);
+				else
+				if (port->isOutput() || !port->isMarked())
+					connects1.insert(connect);
+			}
+		}
+	}
+
+	foreach (qpwgraph_connect *connect, connects2)
+		connect->setMarked(false);
+
+	foreach (qpwgraph_connect *connect, connects1) {
+		removeItem(connect);
+		delete connect;
+	}
+
+	QList<qpwgraph_node *> nodes1;
+
+	foreach (qpwgraph_node *node, nodes) {
+		if (node->isMarked()) {
+			node->resetPorts();
+			node->setMarked(false);
+		} else {
+			nodes1.append(node);
+		}
+	}
+
+	foreach (qpwgraph_node *node, nodes1)
+		removeItem(node);
+
+	qDeleteAll(nodes1);
+}
+
+
 void qpwgraph_sect::clearItems ( uint node_type )
 {
 	qpwgraph_sect::resetItems(node_type);
@@ -107,6 +154,27 @@ qpwgraph_node *qpwgraph_sect::findNode (
 }
 
 
+// Node port-edit scopes, committed all at once,
+// so that ports get sorted and laid out only once.
+void qpwgraph_sect::beginNodeEdit ( qpwgraph_node *node )
+{
+	if (node->isPortsEdit())
+		return;
+
+	node->beginPortsEdit();
+	m_nodes_edit.append(node);
+}
+
+
+void qpwgraph_sect::commitNodeEdits (void)
+{
+	foreach (qpwgraph_node *node, m_nodes_edit)
+		node->commitPortsEdit();
+
+	m_nodes_edit.clear();
+}
+
+
 // Client/port renaming method.
 void qpwgraph_sect::renameItem (
 	qpwgraph_item *item, const QString& name )
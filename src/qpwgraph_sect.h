@@ -26,6 +26,7 @@
 
 #include <QObject>
 #include <QList>
+#include <QSet>
 
 
 // Forwards decls.
@@ -55,9 +56,17 @@ public:
 	void resetItems(uint node_type);
 	void clearItems(uint node_type);
 
+	// Clean-up un-marked items of the given nodes only...
+	void resetNodeItems(const QSet<qpwgraph_node *>& nodes);
+
 	// Special node finder.
 	qpwgraph_node *findNode(uint id, qpwgraph_item::Mode mode, uint type = 0) const;
 
+	// Node port-edit scopes, committed all at once,
+	// so that ports get sorted and laid out only once.
+	void beginNodeEdit(qpwgraph_node *node);
+	void commitNodeEdits();
+
 	// Client/port renaming method.
 	virtual void renameItem(qpwgraph_item *item, const QString& name);
 
@@ -67,6 +76,8 @@ private:
 	qpwgraph_canvas *m_canvas;
 
 	QList<qpwgraph_connect *> m_connects;
+
+	QList<qpwgraph_node *> m_nodes_edit;
 };
 
 
@@ -0,0 +1,189 @@
+// qpwgraph_shadow.cpp
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qpwgraph_shadow.h"
+
+#include <QPainter>
+#include <QPalette>
+#include <QPixmapCache>
+#include <QImage>
+
+#include <qdrawutil.h>
+
+
+// Node rectangle corner radius (as in qpwgraph_node::updatePath).
+#define SHADOW_CORNER_RADIUS 5
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_shadow -- Node drop-shadow graphics item.
+
+// Constructor.
+qpwgraph_shadow::qpwgraph_shadow ( QGraphicsItem *parent )
+	: QGraphicsItem(parent)
+{
+	QGraphicsItem::setFlag(QGraphicsItem::ItemStacksBehindParent);
+	QGraphicsItem::setAcceptedMouseButtons(Qt::NoButton);
+
+	const QPalette pal;
+	const bool is_darkest = (pal.base().color().value() < 24);
+	m_color = (is_darkest ? Qt::white : Qt::black);
+	m_color.setAlpha(180);
+	m_blur = (is_darkest ? 8 : 16);
+	m_offset = (is_darkest ? 0 : 2);
+}
+
+
+// Shadow (parent node) rectangle.
+void qpwgraph_shadow::setRect ( const QRectF& rect )
+{
+	if (m_rect == rect)
+		return;
+
+	QGraphicsItem::prepareGeometryChange();
+
+	m_rect = rect;
+}
+
+
+const QRectF& qpwgraph_shadow::rect (void) const
+{
+	return m_rect;
+}
+
+
+// Graphics item overrides.
+QRectF qpwgraph_shadow::boundingRect (void) const
+{
+	return m_rect.adjusted(-m_blur, -m_blur, +m_blur, +m_blur)
+		.translated(m_offset, m_offset);
+}
+
+
+QPainterPath qpwgraph_shadow::shape (void) const
+{
+	return QPainterPath();
+}
+
+
+void qpwgraph_shadow::paint ( QPainter *painter,
+	const QStyleOptionGraphicsItem */*option*/, QWidget */*widget*/ )
+{
+	if (!g_enabled || m_rect.isEmpty())
+		return;
+
+	const QPixmap& pm = pixmap(m_color, m_blur);
+	const int m = (pm.width() - 1) / 2;
+	qDrawBorderPixmap(painter, boundingRect().toRect(),
+		QMargins(m, m, m, m), pm);
+}
+
+
+// Shared 9-slice pixmap (cached by color and blur radius).
+QPixmap qpwgraph_shadow::pixmap ( const QColor& color, int blur )
+{
+	const QString& key = QString("qpwgraph_shadow:%1:%2")
+		.arg(color.rgba(), 0, 16).arg(blur);
+
+	QPixmap pm;
+	if (QPixmapCache::find(key, &pm))
+		return pm;
+
+	// A rounded square, inset by the blur radius, large enough
+	// that its center row and column are fully opaque, so that
+	// the 9-slice margins are exactly half of its size...
+	const int c = SHADOW_CORNER_RADIUS;
+	const int s = 2 * (blur + c) + 1;
+	const int w = 2 * blur + s;
+
+	QImage image(w, w, QImage::Format_ARGB32_Premultiplied);
+	image.fill(Qt::transparent);
+
+	QPainter painter(&image);
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.setPen(Qt::NoPen);
+	painter.setBrush(color);
+	painter.drawRoundedRect(QRectF(blur, blur, s, s), c, c);
+	painter.end();
+
+	// Three box-blur passes (~gaussian), both directions,
+	// over the raw (premultiplied) pixel data...
+	QRgb *bits = reinterpret_cast<QRgb *> (image.bits());
+	const int stride = image.bytesPerLine() / sizeof(QRgb);
+	const int r = qMax(1, blur / 3);
+	const int n = 2 * r + 1;
+	QVector<QRgb> line(w);
+	for (int pass = 0; pass < 3; ++pass) {
+		for (int dir = 0; dir < 2; ++dir) {
+			const int di = (dir == 0 ? 1 : stride);
+			const int dj = (dir == 0 ? stride : 1);
+			for (int j = 0; j < w; ++j) {
+				QRgb *p = bits + j * dj;
+				for (int i = 0; i < w; ++i)
+					line[i] = p[i * di];
+				int sa = 0, sr = 0, sg = 0, sb = 0;
+				for (int i = 0; i < r && i < w; ++i) {
+					const QRgb v = line.at(i);
+					sa += qAlpha(v); sr += qRed(v);
+					sg += qGreen(v); sb += qBlue(v);
+				}
+				for (int i = 0; i < w; ++i) {
+					const int i1 = i + r;
+					if (i1 < w) {
+						const QRgb v1 = line.at(i1);
+						sa += qAlpha(v1); sr += qRed(v1);
+						sg += qGreen(v1); sb += qBlue(v1);
+					}
+					const int i0 = i - r - 1;
+					if (i0 >= 0) {
+						const QRgb v0 = line.at(i0);
+						sa -= qAlpha(v0); sr -= qRed(v0);
+						sg -= qGreen(v0); sb -= qBlue(v0);
+					}
+					p[i * di] = qRgba(sr / n, sg / n, sb / n, sa / n);
+				}
+			}
+		}
+	}
+
+	pm = QPixmap::fromImage(image);
+	QPixmapCache::insert(key, pm);
+
+	return pm;
+}
+
+
+// Global enablement.
+//
+bool qpwgraph_shadow::g_enabled = true;
+
+void qpwgraph_shadow::setShadowsEnabled ( bool on )
+{
+	g_enabled = on;
+}
+
+bool qpwgraph_shadow::isShadowsEnabled (void)
+{
+	return g_enabled;
+}
+
+
+// end of qpwgraph_shadow.cpp
@@ -0,0 +1,85 @@
+// qpwgraph_shadow.h
+//
+/****************************************************************************
+   Copyright (C) 2021-2026, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qpwgraph_shadow_h
+#define __qpwgraph_shadow_h
+
+#include <QGraphicsItem>
+
+#include <QColor>
+#include <QPixmap>
+
+
+//----------------------------------------------------------------------------
+// qpwgraph_shadow -- Node drop-shadow graphics item.
+//
+// Stacked behind its parent node; draws a pre-blurred 9-slice pixmap,
+// shared by all shadows of the same color and blur radius, stretched
+// over the node rectangle (no off-screen rendering nor per-item blur).
+//
+
+class qpwgraph_shadow : public QGraphicsItem
+{
+public:
+
+	// Constructor.
+	qpwgraph_shadow(QGraphicsItem *parent);
+
+	// Graphics item type (not a qpwgraph_item, never hit).
+	enum { Type = QGraphicsItem::UserType - 1 };
+
+	int type() const { return Type; }
+
+	// Shadow (parent node) rectangle.
+	void setRect(const QRectF& rect);
+	const QRectF& rect() const;
+
+	// Global enablement.
+	static void setShadowsEnabled(bool on);
+	static bool isShadowsEnabled();
+
+	// Graphics item overrides.
+	QRectF boundingRect() const;
+	QPainterPath shape() const;
+
+	void paint(QPainter *painter,
+		const QStyleOptionGraphicsItem *option, QWidget *widget);
+
+protected:
+
+	// Shared 9-slice pixmap (cached by color and blur radius).
+	static QPixmap pixmap(const QColor& color, int blur);
+
+private:
+
+	// Instance variables.
+	QRectF m_rect;
+	QColor m_color;
+	int    m_blur;
+	int    m_offset;
+
+	static bool g_enabled;
+};
+
+
+#endif	// __qpwgraph_shadow_h
+
+// end of qpwgraph_shadow.h
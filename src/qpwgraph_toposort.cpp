@@ -21,497 +21,240 @@
 
 #include "qpwgraph_toposort.h"
 
-#include "qpwgraph_node.h"
-#include "qpwgraph_port.h"
-#include "qpwgraph_connect.h"
-
-#include <QMap>
-#include <cmath>
+#include <algorithm>
 
 
 //----------------------------------------------------------------------------
 // qpwgraph_toposort -- Topological sort and related code for graph nodes impl.
 //
 
-qpwgraph_toposort::qpwgraph_toposort ( const QList<qpwgraph_node *>& nodes )
-	: m_inputNodes(nodes)
+qpwgraph_toposort::qpwgraph_toposort ( const qpwgraph_layout::Graph& graph )
+	: m_graph(graph)
 {
 }
 
 
-// Rearrange nodes by type and connection using a topological ordering.
-// Nodes with no incoming connections go first, nodes with no outgoing
-// connections go last.  Nodes are arranged in columns based on their distance
-// in the graph from a source node.
+// Rank nodes by type and connection using a topological ordering.  Nodes
+// with no incoming connections go first, nodes with no outgoing connections
+// go last.  Nodes are ranked in columns based on their distance in the graph
+// from a source node.
 //
-// Returns a Map from node pointer to position, without modifying the nodes.
-const QHash<qpwgraph_node *, QPointF>& qpwgraph_toposort::arrange ( const QRect& viewportRect )
+// Returns ranks by node index, without modifying the snapshot.
+const QVector<int>& qpwgraph_toposort::rank (void)
 {
 	// Sort nodes topologically, using heuristics to break cycles.
 	rankAndSort();
 
-	// Precompute and store information used during arrangement.
-	QMap<int, QList<qpwgraph_node *>> rankNodes;
-	QMap<int, qreal> rankMaxWidth;
-	qreal xmin = std::numeric_limits<double>::infinity();
-	qreal ymin = std::numeric_limits<double>::infinity();
-	int maxRank = 0;
-	foreach (qpwgraph_node *n, m_inputNodes) {
-		int rank = m_nodeRanks[n];
-		if (!rankNodes.contains(rank)) {
-			rankNodes[rank] = QList<qpwgraph_node *>();
-		}
-		rankNodes[rank] << n;
-
-		if (!rankMaxWidth.contains(rank)) {
-			rankMaxWidth[rank] = 0;
-		}
-		rankMaxWidth[rank] = qMax(rankMaxWidth[rank], n->boundingRect().width());
+	return m_nodeRanks;
+}
 
-		maxRank = qMax(maxRank, rank);
 
-		xmin = qMin(xmin, n->pos().x());
-		ymin = qMin(ymin, n->pos().y());
-	}
-
-	// Calculate total space required for all columns plus margins, for
-	// expanding to fill viewport width.
-	qreal totalColumnWidths = 40.0;
-	foreach (qreal w, rankMaxWidth) {
-		totalColumnWidths += w;
-	}
+// Snapshot node indexes, sorted by rank (valid after rank()).
+const QVector<int>& qpwgraph_toposort::sortedNodes (void) const
+{
+	return m_sortedNodes;
+}
 
-	// Place nodes based on topological sort
-	const qreal xpad = qMax(40.0, (viewportRect.width() - totalColumnWidths) / qMax(2, rankMaxWidth.size() - 1));
-	const qreal ypad = 20.0;
-	qreal x = xmin, y = ymin;
-	int current_rank = m_nodeRanks[m_inputNodes.first()];
-	foreach (qpwgraph_node *node, m_inputNodes) {
-		if (m_nodeRanks[node] != current_rank) {
-			// End of a rank; reset Y and move to the next column
-			y = ymin;
-
-			x += rankMaxWidth[current_rank] + xpad;
-			current_rank = m_nodeRanks[node];
-		}
 
-		const qreal w = node->boundingRect().width();
-		if (current_rank == 0) {
-			// Right-align sources
-			m_newPositions[node] = QPointF(x + (rankMaxWidth[current_rank] - w), y);
-		} else if (current_rank == maxRank) {
-			// Left-align sinks
-			m_newPositions[node] = QPointF(x, y);
+// Assigns ranks to and sorts the nodes of the snapshot.  Sort occurs in the
+// sortedNodes member variable.
+//
+// Ranking is longest-path layering, in linear time: a single iterative
+// depth-first search (from effective sources first, then from whatever
+// is left, in sorted order) yields a topological order where the only
+// backward edges are the ones closing a cycle; those feedback edges are
+// ignored and every other edge gets relaxed once, in that order.
+void qpwgraph_toposort::rankAndSort (void)
+{
+	buildNodeTables();
+
+	const int count = m_graph.nodes.size();
+
+	m_nodeRanks.fill(0, count);
+	m_sortedNodes.resize(count);
+	for (int i = 0; i < count; ++i) {
+		const qpwgraph_layout::Node& n = m_graph.nodes.at(i);
+		if (n.inputs == 0) {
+			m_nodeRanks[i] = 0;
+		} else if (n.outputs == 0) {
+			m_nodeRanks[i] = 2;
 		} else {
-			// Center-align everything else
-			m_newPositions[node] = QPointF(x + (rankMaxWidth[current_rank] - w) / 2, y);
+			m_nodeRanks[i] = 1;
 		}
-
-		y += node->boundingRect().height() + ypad;
+		m_sortedNodes[i] = i;
 	}
 
-	// Move columns vertically for shorter and neater wires
-	for (int i = 1; i <= maxRank; i++) {
-		if (!rankNodes.contains(i)) {
-			continue;
-		}
-
-		// Sort each column by average connection source port Y value
-		// to place nodes vertically closer to their upstream nodes.
-		sortNodesByConnectionY(rankNodes[i]);
+	if (count < 1) {
+		return;
+	}
 
-		qreal minY = m_newPositions[rankNodes[i].first()].y();
-		foreach (qpwgraph_node *n, rankNodes[i]) {
-			minY = qMin(minY, m_newPositions[n].y());
+	// Sort before for best cycle-breaking heuristics
+	sortNodesByRank(m_sortedNodes);
+
+	// Search roots: effective sources first, then everything else
+	QVector<int> roots;
+	roots.reserve(2 * count);
+	foreach (int i, m_sortedNodes) {
+		if (m_graph.nodes.at(i).input_connects == 0) {
+			roots.append(i);
 		}
+	}
+	roots += m_sortedNodes;
 
-		qreal y = minY;
-		foreach (qpwgraph_node *n, rankNodes[i]) {
-			m_newPositions[n] = QPointF(m_newPositions[n].x(), y);
-			y += n->boundingRect().height() + ypad;
+	// Iterative depth-first search, collecting nodes in post-order
+	QVector<bool> visited(count, false);
+	QVector<int> order;
+	order.reserve(count);
+	QVector<QPair<int, int>> stack;
+	stack.reserve(count);
+	foreach (int root, roots) {
+		if (visited.at(root)) {
+			continue;
 		}
-
-		// Center each column's average input port Y value on the source ports' average Y value
-		qreal parentY = meanParentPortY(rankNodes[i], m_newPositions);
-		qreal inputY = meanInputPortY(rankNodes[i], m_newPositions);
-		qreal delta = inputY - parentY;
-		if (std::isfinite(delta)) {
-			foreach (qpwgraph_node *n, rankNodes[i]) {
-				QPointF &pos = m_newPositions[n];
-				m_newPositions[n] = QPointF(pos.x(), pos.y() - delta);
+		visited[root] = true;
+		stack.append(qMakePair(root, 0));
+		while (!stack.isEmpty()) {
+			QPair<int, int>& top = stack.last();
+			const QVector<int>& children = m_children.at(top.first);
+			if (top.second < children.size()) {
+				const int next = children.at(top.second++);
+				if (!visited.at(next)) {
+					visited[next] = true;
+					stack.append(qMakePair(next, 0));
+				}
+			} else {
+				order.append(top.first);
+				stack.removeLast();
 			}
 		}
 	}
 
-	return m_newPositions;
-}
-
-
-// Assigns ranks to and sorts the nodes given to the constructor.  Sort occurs
-// in-place in the inputNodes member variable.
-void qpwgraph_toposort::rankAndSort (void)
-{
-	foreach (qpwgraph_node *n, m_inputNodes) {
-		if (nodeIsTrueSource(n)) {
-			m_nodeRanks[n] = 0;
-		} else if (nodeIsTrueSink(n)) {
-			m_nodeRanks[n] = 2;
-		} else {
-			m_nodeRanks[n] = 1;
-		}
+	// Reverse post-order is a topological order, less the feedback edges
+	QVector<int> positions(count);
+	for (int k = 0; k < count; ++k) {
+		positions[order.at(k)] = count - 1 - k;
 	}
 
-	// Sort before for best cycle-breaking heuristics
-	sortNodesByRank(m_inputNodes);
-	m_unvisitedNodes.clear();
-	m_unvisitedNodes << m_inputNodes;
-
-	// Visit sources
-	foreach (qpwgraph_node *n, m_inputNodes) {
-		if (nodeIsEffectiveSource(n)) {
-			visitNode(QSet<qpwgraph_node *>(), n);
-		}
-	}
-
-	// Break cycles
-	while (!m_unvisitedNodes.empty()) {
-		qsizetype initialCount = m_unvisitedNodes.size();
-
-		qpwgraph_node *n = m_unvisitedNodes.first();
-		visitNode(QSet<qpwgraph_node *>(), n);
-
-		if (initialCount == m_unvisitedNodes.size()) {
-			// This is a bug but we don't want an infinite loop
-			break;
+	// Longest-path layering, each edge relaxed exactly once
+	for (int k = count - 1; k >= 0; --k) {
+		const int i = order.at(k);
+		foreach (int next, m_children.at(i)) {
+			if (positions.at(next) < positions.at(i)) {
+				// Cycle detected; skip this feedback edge
+				continue;
+			}
+			m_nodeRanks[next] = qMax(m_nodeRanks.at(i) + 1, m_nodeRanks.at(next));
 		}
 	}
 
 	// Place sink nodes at final rank
 	int sinkDepth = 2;
-	foreach (qpwgraph_node *n, m_inputNodes) {
-		if (nodeIsTrueSink(n)) {
-			sinkDepth = qMax(sinkDepth, m_nodeRanks[n]);
+	for (int i = 0; i < count; ++i) {
+		if (m_graph.nodes.at(i).outputs == 0) {
+			sinkDepth = qMax(sinkDepth, m_nodeRanks.at(i));
 		} else {
-			sinkDepth = qMax(sinkDepth, m_nodeRanks[n] + 1);
+			sinkDepth = qMax(sinkDepth, m_nodeRanks.at(i) + 1);
 		}
 	}
-	foreach (qpwgraph_node *n, m_inputNodes) {
-		if (nodeIsTrueSink(n)) {
-			m_nodeRanks[n] = qMax(m_nodeRanks[n], sinkDepth);
+	for (int i = 0; i < count; ++i) {
+		if (m_graph.nodes.at(i).outputs == 0) {
+			m_nodeRanks[i] = qMax(m_nodeRanks.at(i), sinkDepth);
 		}
 	}
 
 	// Sort again with computed ranks
-	sortNodesByRank(m_inputNodes);
+	sortNodesByRank(m_sortedNodes);
 }
 
 
-// Depth-first iteration of all children of the given node to assign ranks.
-void qpwgraph_toposort::visitNode (
-	const QSet<qpwgraph_node *>& path, qpwgraph_node *n )
+// Precomputes (deduplicated) children of each node, just once.
+void qpwgraph_toposort::buildNodeTables (void)
 {
-	m_unvisitedNodes.removeOne(n);
-
-	auto newPath = QSet<qpwgraph_node *>(path);
-	newPath += n;
+	const int count = m_graph.nodes.size();
 
-	foreach (qpwgraph_node *next, childNodes(n)) {
-		if (newPath.contains(next)) {
-			// Cycle detected; skip this child node
-			continue;
-		}
+	m_children.clear();
+	m_children.resize(count);
 
-		int newDepth = qMax(m_nodeRanks[n] + 1, m_nodeRanks[next]);
-		m_nodeRanks[next] = newDepth;
-
-		visitNode(newPath, next);
+	QVector<int> stamps(count, -1);
+	QVector<int> edges(m_graph.edges.size());
+	for (int k = 0; k < edges.size(); ++k) {
+		edges[k] = k;
 	}
-}
-
-
-void qpwgraph_toposort::sortNodesByRank ( QList<qpwgraph_node *>& nodes )
-{
-	std::sort(nodes.begin(), nodes.end(),
-		[this](qpwgraph_node *n1, qpwgraph_node *n2)
-			{ return compareNodes(n1, n2); });
-}
-
-
-void qpwgraph_toposort::sortNodesByConnectionY ( QList<qpwgraph_node *>& nodes )
-{
-	std::sort(nodes.begin(), nodes.end(),
-		[this](qpwgraph_node *n1, qpwgraph_node *n2)
-			{ return compareNodesByConnectionLocation(n1, n2); });
-}
 
+	// Group edges by source node, so that stamps work one node at a time
+	std::stable_sort(edges.begin(), edges.end(),
+		[this](int e1, int e2)
+			{ return m_graph.edges.at(e1).node1 < m_graph.edges.at(e2).node1; });
 
-qsizetype qpwgraph_toposort::countInputPorts ( qpwgraph_node *n )
-{
-	return std::count_if(n->ports().begin(), n->ports().end(),
-		[](qpwgraph_port *p) { return p->isInput(); });
-}
-
-
-qsizetype qpwgraph_toposort::countOutputPorts ( qpwgraph_node *n )
-{
-	return std::count_if(n->ports().begin(), n->ports().end(),
-		[](qpwgraph_port *p) { return p->isOutput(); });
-}
-
-
-// Counts connections that do not have the same source and destination node
-qsizetype qpwgraph_toposort::countExternalConnections (
-	qpwgraph_node *n, bool is_input )
-{
-	qsizetype count = 0;
-
-	foreach (qpwgraph_port *p, n->ports()) {
-		if (p->isInput() && is_input) {
-			count += std::count_if(p->connects().begin(), p->connects().end(),
-				[](qpwgraph_connect *c)
-				{ return c->port1()->portNode() != c->port2()->portNode(); });
-		}
-	}
-
-	return count;
-}
-
-
-qsizetype qpwgraph_toposort::countInputConnections ( qpwgraph_node *n )
-{
-	return countExternalConnections(n, true);
-}
-
-
-bool qpwgraph_toposort::nodeIsTrueSource ( qpwgraph_node *n )
-{
-	return countInputPorts(n) == 0;
-}
-
-
-bool qpwgraph_toposort::nodeIsEffectiveSource ( qpwgraph_node *n )
-{
-	return countInputConnections(n) == 0;
-}
-
-
-bool qpwgraph_toposort::nodeIsTrueSink ( qpwgraph_node *n )
-{
-	return countOutputPorts(n) == 0;
-}
-
-
-// Returns all nodes directly connected to output ports of the given node
-QSet<qpwgraph_node *> qpwgraph_toposort::childNodes ( qpwgraph_node *n )
-{
-	auto children = QSet<qpwgraph_node *>();
-
-	foreach (qpwgraph_port *p, n->ports()) {
-		if (p->isInput()) {
+	foreach (int k, edges) {
+		const qpwgraph_layout::Edge& e = m_graph.edges.at(k);
+		if (e.node1 == e.node2) {
 			continue;
 		}
-
-		foreach (qpwgraph_connect *c, p->connects()) {
-			qpwgraph_node *n1 = c->port1()->portNode();
-			qpwgraph_node *n2 = c->port2()->portNode();
-
-			if (n1 == n2) {
-				continue;
-			}
-
-			if (n1 == n) {
-				children << n2;
-			} else {
-				children << n1;
-			}
+		if (stamps.at(e.node2) != e.node1) {
+			stamps[e.node2] = e.node1;
+			m_children[e.node1].append(e.node2);
 		}
 	}
-
-	return children;
 }
 
 
-QSet<qpwgraph_port *> qpwgraph_toposort::connectedParentPorts ( qpwgraph_node *n )
+void qpwgraph_toposort::sortNodesByRank ( QVector<int>& nodes )
 {
-	QSet<qpwgraph_port *> portList;
-
-	foreach (qpwgraph_port *p, n->ports()) {
-		if (!p->isInput()) {
-			continue;
-		}
-
-		foreach (qpwgraph_connect *c, p->connects()) {
-			qpwgraph_node *n1 = c->port1()->portNode();
-			qpwgraph_node *n2 = c->port2()->portNode();
-			if (n1 == n2) {
-				// self feedback
-				continue;
-			}
-
-			if (m_nodeRanks[n1] > m_nodeRanks[n] || m_nodeRanks[n2] > m_nodeRanks[n]) {
-				// left-pointing edge in a cycle
-				continue;
-			}
-
-			if (c->port1()->portNode() == n) {
-				portList << c->port2();
-			} else {
-				portList << c->port1();
-			}
-		}
-	}
-
-	return portList;
-}
-
-
-QSet<qpwgraph_port *> qpwgraph_toposort::connectedInputPorts ( qpwgraph_node *n )
-{
-	QSet<qpwgraph_port *> portList;
-
-	foreach (qpwgraph_port *p, n->ports()) {
-		if (!p->isInput()) {
-			continue;
-		}
-
-		foreach (qpwgraph_connect *c, p->connects()) {
-			qpwgraph_node *n1 = c->port1()->portNode();
-			qpwgraph_node *n2 = c->port2()->portNode();
-			if (n1 == n2) {
-				// self feedback
-				continue;
-			}
-
-			if (m_nodeRanks[n1] > m_nodeRanks[n] || m_nodeRanks[n2] > m_nodeRanks[n]) {
-				// left-pointing edge in a cycle
-				continue;
-			}
-
-			portList << p;
-		}
-	}
-
-	return portList;
+	std::stable_sort(nodes.begin(), nodes.end(),
+		[this](int n1, int n2)
+			{ return compareNodes(n1, n2); });
 }
 
 
-bool qpwgraph_toposort::compareNodes(qpwgraph_node *n1, qpwgraph_node *n2)
+bool qpwgraph_toposort::compareNodes ( int i1, int i2 ) const
 {
-	if (m_nodeRanks[n1] < m_nodeRanks[n2]) {
+	if (m_nodeRanks.at(i1) < m_nodeRanks.at(i2)) {
 		return true;
 	}
-	if (m_nodeRanks[n2] < m_nodeRanks[n1]) {
+	if (m_nodeRanks.at(i2) < m_nodeRanks.at(i1)) {
 		return false;
 	}
 
-	if (n1->ports().empty() && !n2->ports().empty()) {
+	const qpwgraph_layout::Node& n1 = m_graph.nodes.at(i1);
+	const qpwgraph_layout::Node& n2 = m_graph.nodes.at(i2);
+
+	if (n1.ports == 0 && n2.ports != 0) {
 		return true;
 	}
-	if (n2->ports().empty() && !n1->ports().empty()) {
+	if (n2.ports == 0 && n1.ports != 0) {
 		return false;
 	}
 
-	if (!(n1->ports().empty() || n2->ports().empty())) {
-		if (n1->ports().first()->portType() < n2->ports().first()->portType()) {
-			return true;
-		}
-		if (n2->ports().first()->portType() < n1->ports().first()->portType()) {
-			return false;
-		}
-	}
-
-	if (countInputPorts(n1) < countInputPorts(n2)) {
+	if (n1.port_type < n2.port_type) {
 		return true;
 	}
-	if (countInputPorts(n2) < countInputPorts(n1)) {
+	if (n2.port_type < n1.port_type) {
 		return false;
 	}
 
-	if (countOutputPorts(n1) < countOutputPorts(n2)) {
+	if (n1.inputs < n2.inputs) {
 		return true;
 	}
-	if (countOutputPorts(n2) < countOutputPorts(n1)) {
+	if (n2.inputs < n1.inputs) {
 		return false;
 	}
 
-	if (n1->nodeName() < n2->nodeName()) {
+	if (n1.outputs < n2.outputs) {
 		return true;
 	}
-	if (n2->nodeName() < n1->nodeName()) {
+	if (n2.outputs < n1.outputs) {
 		return false;
 	}
 
-	return false;
-}
-
-
-bool qpwgraph_toposort::compareNodesByConnectionLocation (
-	qpwgraph_node *n1, qpwgraph_node *n2 )
-{
-	// Compare port types first so that e.g. MIDI-only nodes still appear above audio nodes
-	if (n1->ports().empty() && !n2->ports().empty()) {
+	if (n1.name < n2.name) {
 		return true;
 	}
-	if (n2->ports().empty() && !n1->ports().empty()) {
+	if (n2.name < n1.name) {
 		return false;
 	}
 
-	if (!(n1->ports().empty() || n2->ports().empty())) {
-		if (n1->ports().first()->portType() < n2->ports().first()->portType()) {
-			return true;
-		}
-		if (n2->ports().first()->portType() < n1->ports().first()->portType()) {
-			return false;
-		}
-	}
-
-	// Compare source port locations
-	return meanParentPortY({n1}, m_newPositions) < meanParentPortY({n2}, m_newPositions);
-}
-
-
-qreal qpwgraph_toposort::meanPortY (
-	const QSet<qpwgraph_port *>& ports,
-	const QHash<qpwgraph_node *, QPointF>& positions )
-{
-	if (ports.empty()) {
-		return -std::numeric_limits<double>::infinity();
-	}
-
-	qreal y = 0;
-	foreach (qpwgraph_port *p, ports) {
-		y += p->pos().y() + positions[p->portNode()].y();
-	}
-
-	return y / ports.size();
-}
-
-
-qreal qpwgraph_toposort::meanParentPortY (
-	const QList<qpwgraph_node *>& nodes,
-	const QHash<qpwgraph_node *, QPointF>& positions )
-{
-	auto ports = QSet<qpwgraph_port *>();
-
-	foreach (qpwgraph_node *n, nodes) {
-		ports |= connectedParentPorts(n);
-	}
-
-	return meanPortY(ports, positions);
-}
-
-
-qreal qpwgraph_toposort::meanInputPortY (
-	const QList<qpwgraph_node *>& nodes,
-	const QHash<qpwgraph_node *, QPointF>& positions )
-{
-	auto ports = QSet<qpwgraph_port *>();
-
-	foreach (qpwgraph_node *n, nodes) {
-		ports |= connectedInputPorts(n);
-	}
-
-	return meanPortY(ports, positions);
+	return false;
 }
 
 
@@ -23,17 +23,15 @@
 #ifndef __qpwgraph_toposort_h
 #define __qpwgraph_toposort_h
 
-#include "qpwgraph_node.h"
-
-#include <QSet>
+#include "qpwgraph_layout.h"
 
 
 //----------------------------------------------------------------------------
 // qpwgraph_toposort -- Topological sort and related code for graph nodes decl.
 //
 
-// Contains code for topologically sorting nodes, as well as arranging those
-// nodes based on the sort.
+// Contains code for topologically ranking and sorting nodes of a graph
+// snapshot (see qpwgraph_layout), so that it can run off the GUI thread.
 //
 // This class is non-reentrant, so use each instance just once from a single
 // function.
@@ -42,51 +40,33 @@ class qpwgraph_toposort
 public:
 
 	//Constructor.
-	qpwgraph_toposort(const QList<qpwgraph_node *>& nodes);
+	qpwgraph_toposort(const qpwgraph_layout::Graph& graph);
+
+	// Call this to perform ranking and sorting.  Returns node ranks (columns)
+	// in the same index order as the snapshot nodes.
+	const QVector<int>& rank();
 
-	// Call this to perform ranking and node arrangement.  Returns the map
-	// of new positions without applying those positions to the nodes.
-	const QHash<qpwgraph_node *, QPointF>& arrange(const QRect& viewportRect);
+	// Snapshot node indexes, sorted by rank (valid after rank()).
+	const QVector<int>& sortedNodes() const;
 
 protected:
 
 	void rankAndSort();
-	void visitNode(const QSet<qpwgraph_node *>& path, qpwgraph_node *n);
-
-	void sortNodesByRank(QList<qpwgraph_node *>& nodes);
-	void sortNodesByConnectionY(QList<qpwgraph_node *>& nodes);
-
-	static qsizetype countInputPorts(qpwgraph_node *n);
-	static qsizetype countOutputPorts(qpwgraph_node *n);
-
-	static qsizetype countExternalConnections(qpwgraph_node *n, bool input);
-	static qsizetype countInputConnections(qpwgraph_node *n);
+	void buildNodeTables();
 
-	static bool nodeIsTrueSource(qpwgraph_node *n);
-	static bool nodeIsEffectiveSource(qpwgraph_node *n);
-	static bool nodeIsTrueSink(qpwgraph_node *n);
+	void sortNodesByRank(QVector<int>& nodes);
 
-	static QSet<qpwgraph_node *> childNodes(qpwgraph_node *n);
-
-	QSet<qpwgraph_port *> connectedParentPorts(qpwgraph_node *n);
-	QSet<qpwgraph_port *> connectedInputPorts(qpwgraph_node *n);
-	QSet<qpwgraph_port *> connectedOutputPorts(qpwgraph_node *n);
-
-	qreal meanPortY(const QSet<qpwgraph_port *>& ports, const QHash<qpwgraph_node *, QPointF>& positions);
-	qreal meanParentPortY(const QList<qpwgraph_node *>& nodes, const QHash<qpwgraph_node *, QPointF>& positions);
-	qreal meanInputPortY(const QList<qpwgraph_node *>& nodes, const QHash<qpwgraph_node *, QPointF>& positions);
-
-	bool compareNodes(qpwgraph_node *n1, qpwgraph_node *n2);
-	bool compareNodesByConnectionLocation(qpwgraph_node *n1, qpwgraph_node *n2);
+	bool compareNodes(int n1, int n2) const;
 
 private:
 
 	// Instance variables
-	QList<qpwgraph_node *> m_inputNodes;
-	QList<qpwgraph_node *> m_unvisitedNodes;
+	const qpwgraph_layout::Graph& m_graph;
+
+	QVector<QVector<int>> m_children;
 
-	QHash<qpwgraph_node *, QPointF> m_newPositions;
-	QHash<qpwgraph_node *, int> m_nodeRanks;
+	QVector<int> m_sortedNodes;
+	QVector<int> m_nodeRanks;
 };
 
 #endif /* __qpwgraph_toposort_h */